@@ -3,6 +3,8 @@ import torch
 import torch.nn as nn
 import torch.optim as optim
 import random
+import struct
+import time
 from collections import deque, namedtuple
 import matplotlib.pyplot as plt
 
@@ -216,6 +218,8 @@ def train_scheduler(num_episodes=10):
     env = CPUEnvironment()
     scheduler = DQNScheduler()
     rewards_history = []
+    steps = 0
+    start = time.perf_counter()
 
     for episode in range(num_episodes):
         state = env.reset()
@@ -231,6 +235,7 @@ def train_scheduler(num_episodes=10):
 
             state = next_state
             total_reward += reward
+            steps += 1
 
         # if episode % 10 == 0:
         scheduler.update_target_network()
@@ -239,9 +244,67 @@ def train_scheduler(num_episodes=10):
         )
         rewards_history.append(total_reward)
 
+    # Comparable with build/train_dqn's line
+    seconds = time.perf_counter() - start
+    print(f"Trained {steps} steps in {seconds:.2f} s ({steps / seconds:.0f} steps/s)")
     return scheduler, env, rewards_history
 
 
+# Weights export for the C++ inference in dqn.h
+DQN_MAGIC = b"QDQN\0\0\0\0"
+DQN_VERSION = 1
+DQN_MAX_LAYERS = 7
+MASK64 = (1 << 64) - 1
+
+
+def file_checksum(data):
+    """file_checksum() of checksum.h"""
+    p1, p2 = 0x9E3779B185EBCA87, 0xC2B2AE3D27D4EB4F
+
+    def rotl(x, k):
+        return ((x << k) | (x >> (64 - k))) & MASK64
+
+    lanes = [p1, p2, ~p1 & MASK64, ~p2 & MASK64]
+    i = 0
+    while i + 32 <= len(data):
+        for l in range(4):
+            (word,) = struct.unpack_from("<Q", data, i + 8 * l)
+            lanes[l] = (rotl((lanes[l] + word * p2) & MASK64, 31) * p1) & MASK64
+        i += 32
+    h = (rotl(lanes[0], 1) + rotl(lanes[1], 7) + rotl(lanes[2], 12) + rotl(lanes[3], 18)) & MASK64
+    for byte in data[i:]:
+        h = ((h ^ byte) * p1) & MASK64
+    h ^= len(data)
+    h ^= h >> 33
+    h = (h * p2) & MASK64
+    h ^= h >> 29
+    return h
+
+
+def export_weights(net, path):
+    """Write the network in the format DqnModel::load() reads"""
+    linears = [net.fc1, net.fc2, net.fc3]
+    dims = [linears[0].in_features] + [layer.out_features for layer in linears]
+    weights = bytearray()
+    for layer in linears:
+        for tensor in (layer.weight, layer.bias):
+            values = tensor.detach().cpu().flatten().tolist()
+            weights += struct.pack("<%df" % len(values), *values)
+    dims += [0] * (DQN_MAX_LAYERS + 1 - len(dims))
+    header = DQN_MAGIC + struct.pack(
+        "<II%dIQQ" % len(dims),
+        DQN_VERSION,
+        len(linears),
+        *dims,
+        len(weights),
+        file_checksum(bytes(weights)),
+    )
+    header += struct.pack("<Q", file_checksum(header))
+    with open(path, "wb") as f:
+        f.write(header)
+        f.write(weights)
+
+
 # Training and visualization
 def plot_metrics(rewards_history, env):
     plt.figure(figsize=(15, 5))
@@ -270,4 +333,5 @@ def plot_metrics(rewards_history, env):
 
 if __name__ == "__main__":
     scheduler, env, rewards_history = train_scheduler(num_episodes=50)
+    export_weights(scheduler.policy_net, "dqn_weights.bin")
     plot_metrics(rewards_history, env)
@@ -8,12 +8,23 @@ CONFIG += c++17
 # In order to do so, uncomment the following line.
 #DEFINES += QT_DISABLE_DEPRECATED_BEFORE=0x060000    # disables all the APIs deprecated before Qt 6.0.0
 
+# Simulation engine, built by `make` in the repository root
+INCLUDEPATH += ..
+LIBS += -L$$PWD/../build -lqsim -lm -pthread
+PRE_TARGETDEPS += $$PWD/../build/libqsim.a
+
 SOURCES += \
     main.cpp \
-    mainwindow.cpp
+    mainwindow.cpp \
+    simworker.cpp \
+    tablemodels.cpp
 
 HEADERS += \
-    mainwindow.h
+    ../sim_engine.h \
+    mainwindow.h \
+    simworker.h \
+    spscqueue.h \
+    tablemodels.h
 
 FORMS += \
     mainwindow.ui
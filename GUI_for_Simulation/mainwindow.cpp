@@ -1,17 +1,16 @@
 #include "mainwindow.h"
 #include <QVBoxLayout>
+#include <QHBoxLayout>
 #include <QSpinBox>
-#include <QTableWidget>
+#include <QTableView>
 #include <QPushButton>
 #include <QLabel>
-#include <QFile>
-#include <QTextStream>
-#include <QProcess>
 #include <QStackedWidget>
 #include <QHeaderView>
 
 // MainWindow Constructor
-MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), currentFileIndex(0) {
+MainWindow::MainWindow(QWidget* parent)
+    : QMainWindow(parent), workerThread(nullptr), worker(nullptr), paused(false) {
     setupBasePage();
     setupSimulationPage();
 
@@ -28,25 +27,23 @@ MainWindow::MainWindow(QWidget* parent) : QMainWindow(parent), currentFileIndex(
     stackedWidget->setCurrentWidget(basePage);
 }
 
+MainWindow::~MainWindow() {
+    stopSimulation();
+}
+
 // Setup for Base Page
 void MainWindow::setupBasePage() {
     basePage = new QWidget(this);
 
     // Widgets
     processCountInput = new QSpinBox(basePage);
-    processCountInput->setRange(1, 100);
+    processCountInput->setRange(1, 1000000);
     processCountInput->setValue(4);
 
-    processTable = new QTableWidget(basePage);
-    processTable->setColumnCount(7);
-    processTable->setHorizontalHeaderLabels({"ID", "Burst", "Wait", "Priority", "CPU%", "Memory%", "Completed"});
-
-    // Set column widths
-    processTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
-    for (int i = 0; i < processTable->columnCount(); ++i) {
-        processTable->horizontalHeader()->setMinimumSectionSize(120);
-    }
-    processTable->horizontalHeader()->setStretchLastSection(true); // Last column snaps to the window
+    workloadModel = new WorkloadModel(this);
+    processTable = new QTableView(basePage);
+    processTable->setModel(workloadModel);
+    configureTable(processTable);
 
     simulateButton = new QPushButton("Simulate", basePage);
 
@@ -69,27 +66,34 @@ void MainWindow::setupSimulationPage() {
 
     // Widgets
     processExecutionLabel = new QLabel("Will now execute Process ID: -", simulationPage);
-    processStatesTable = new QTableWidget(simulationPage);
-    qTable = new QTableWidget(simulationPage);
+    processStateModel = new ProcessStateModel(this);
+    qValueModel = new QValueModel(this);
+    processStatesTable = new QTableView(simulationPage);
+    processStatesTable->setModel(processStateModel);
+    qTable = new QTableView(simulationPage);
+    qTable->setModel(qValueModel);
+    playButton = new QPushButton("Pause", simulationPage);
     nextButton = new QPushButton("Next", simulationPage);
-
-    // Configure Process States Table
-    processStatesTable->setColumnCount(7);
-    processStatesTable->setHorizontalHeaderLabels({"ID", "Burst", "Wait", "Priority", "CPU%", "Memory%", "Completed"});
-    processStatesTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
-    for (int i = 0; i < processStatesTable->columnCount(); ++i) {
-        processStatesTable->horizontalHeader()->setMinimumSectionSize(120);
-    }
-    processStatesTable->horizontalHeader()->setStretchLastSection(true);
-
-    // Configure Q-Table
-    qTable->setColumnCount(6);
-    qTable->setHorizontalHeaderLabels({"Process ID", "Priority", "CPU Utilization", "Memory Usage", "Waiting Time", "Burst Time"});
-    qTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
-    for (int i = 0; i < qTable->columnCount(); ++i) {
-        qTable->horizontalHeader()->setMinimumSectionSize(120);
-    }
-    qTable->horizontalHeader()->setStretchLastSection(true);
+    nextButton->setEnabled(false);
+    speedInput = new QComboBox(simulationPage);
+    speedInput->addItem("1 step/s", 1);
+    speedInput->addItem("10 steps/s", 10);
+    speedInput->addItem("100 steps/s", 100);
+    speedInput->addItem("1000 steps/s", 1000);
+    speedInput->addItem("Full speed", 0);
+    speedInput->setCurrentIndex(1);
+    progressBar = new QProgressBar(simulationPage);
+    progressBar->setRange(0, 1000);
+    progressBar->setTextVisible(false);
+
+    refreshTimer = new QTimer(this);
+    refreshTimer->setInterval(16); // about 60 frames per second
+
+    // Configure Process States Table and Q-Table
+    configureTable(processStatesTable);
+    configureTable(qTable);
+    processStatesTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    qTable->setEditTriggers(QAbstractItemView::NoEditTriggers);
 
     // Layout
     auto* layout = new QVBoxLayout(simulationPage);
@@ -98,103 +102,149 @@ void MainWindow::setupSimulationPage() {
     layout->addWidget(processStatesTable);
     layout->addWidget(new QLabel("Q-Table:", simulationPage));
     layout->addWidget(qTable);
-    layout->addWidget(nextButton);
+    layout->addWidget(progressBar);
+    auto* controls = new QHBoxLayout();
+    controls->addWidget(playButton);
+    controls->addWidget(nextButton);
+    controls->addWidget(new QLabel("Speed:", simulationPage));
+    controls->addWidget(speedInput);
+    layout->addLayout(controls);
+
+    connect(playButton, &QPushButton::clicked, this, &MainWindow::togglePaused);
+    connect(nextButton, &QPushButton::clicked, this, [this] {
+        if (worker) {
+            worker->stepOnce();
+        }
+    });
+    connect(speedInput, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::changeSpeed);
+    connect(refreshTimer, &QTimer::timeout, this, &MainWindow::refresh);
+}
 
-    connect(nextButton, &QPushButton::clicked, this, &MainWindow::loadNextFile);
+// Column widths and fixed-height rows, so views of very large tables
+// never measure their rows
+void MainWindow::configureTable(QTableView* table) {
+    table->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+    table->horizontalHeader()->setMinimumSectionSize(120);
+    table->horizontalHeader()->setStretchLastSection(true); // Last column snaps to the window
+    table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
 }
 
 // Update Process Table Rows
 void MainWindow::updateTableRows(int rowCount) {
-    processTable->setRowCount(rowCount);
-    for (int i = 0; i < rowCount; ++i) {
-        if (!processTable->item(i, 0)) {
-            processTable->setItem(i, 0, new QTableWidgetItem(QString::number(i)));
-        }
-    }
+    workloadModel->setProcessCount(rowCount);
 }
 
 // Simulate Button Clicked
 void MainWindow::simulate() {
-    QStringList processData;
-    for (int i = 0; i < processTable->rowCount(); ++i) {
-        QStringList row;
-        for (int j = 0; j < processTable->columnCount(); ++j) {
-            auto* item = processTable->item(i, j);
-            row << (item ? item->text() : "");
-        }
-        processData << row.join(",");
-    }
+    stopSimulation();
 
-    QString inputFile = "input_data.txt";
-    QFile file(inputFile);
-    if (file.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        QTextStream out(&file);
-        out << processData.join("\n");
-        file.close();
+    // Build the workload straight from the table, one process per row
+    std::vector<Process> processes;
+    processes.reserve(workloadModel->rowCount());
+    for (int i = 0; i < workloadModel->rowCount(); ++i) {
+        processes.push_back(workloadModel->process(i));
     }
 
-    QProcess::execute("./simulator", {inputFile});
+    worker = new SimulationWorker(processes);
+    workerThread = new QThread(this);
+    worker->moveToThread(workerThread);
+    connect(workerThread, &QThread::started, worker, &SimulationWorker::run);
+    connect(worker, &SimulationWorker::done, workerThread, &QThread::quit);
+
+    paused = false;
+    playButton->setText("Pause");
+    playButton->setEnabled(true);
+    nextButton->setEnabled(false);
+    speedInput->setEnabled(true);
+    progressBar->setValue(0);
+    worker->setStepsPerSecond(speedInput->currentData().toInt());
 
     // Switch to simulation page
     stackedWidget->setCurrentWidget(simulationPage);
-    loadNextFile();
+    workerThread->start();
+    refreshTimer->start();
 }
 
-// Load Next File
-void MainWindow::loadNextFile() {
-    QString fileName = QString("output_iteration_%1.txt").arg(currentFileIndex++);
-    QFile file(fileName);
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-        processExecutionLabel->setText("All processes executed!");
-        nextButton->setEnabled(false);
+// Stop the running simulation, if any, and wait for its thread
+void MainWindow::stopSimulation() {
+    refreshTimer->stop();
+    if (!worker) {
         return;
     }
+    worker->stop();
+    workerThread->quit();
+    workerThread->wait();
+    delete worker;
+    delete workerThread;
+    worker = nullptr;
+    workerThread = nullptr;
+}
 
-    QTextStream in(&file);
-    QString content = in.readAll();
-    file.close();
-
-    // Parse and display content
-    parseAndDisplayFile(content);
-    if (!QFile::remove(fileName)) {
-        qWarning("Failed to delete the file: %s", qPrintable(fileName));
+// Play/Pause Button Clicked
+void MainWindow::togglePaused() {
+    if (!worker) {
+        return;
     }
+    paused = !paused;
+    worker->setPaused(paused);
+    playButton->setText(paused ? "Play" : "Pause");
+    nextButton->setEnabled(paused);
 }
 
-// Parse and Display File Content
-void MainWindow::parseAndDisplayFile(const QString& content) {
-    QStringList lines = content.split('\n', Qt::SkipEmptyParts);
-
-    // Parse Process States
-    int processStatesStart = lines.indexOf("Current Process States:") + 2;
-    int qTableStart = lines.indexOf("Q-Table:");
+void MainWindow::changeSpeed(int index) {
+    if (worker) {
+        worker->setStepsPerSecond(speedInput->itemData(index).toInt());
+    }
+}
 
-    QStringList processStateLines = lines.mid(processStatesStart, qTableStart - processStatesStart);
-    processStatesTable->setRowCount(processStateLines.size());
-    processStatesTable->setColumnCount(7); // As per your table structure
-    processStatesTable->setHorizontalHeaderLabels({"ID", "Burst", "Wait", "Priority", "CPU%", "Memory%", "Completed"});
+// Show the newest snapshot the worker published since the last refresh;
+// the ones in between are skipped
+void MainWindow::refresh() {
+    bool finished = worker->isFinished();
 
-    for (int i = 0; i < processStateLines.size(); ++i) {
-        QStringList columns = processStateLines[i].split('\t');
-        for (int j = 0; j < columns.size(); ++j) {
-            processStatesTable->setItem(i, j, new QTableWidgetItem(columns[j].trimmed()));
+    int slot;
+    int newest = -1;
+    while (worker->takeSlot(slot)) {
+        if (newest >= 0) {
+            worker->releaseSlot(newest);
         }
+        newest = slot;
+    }
+    if (newest >= 0) {
+        displayFrame(worker->frame(newest));
+        worker->releaseSlot(newest);
     }
 
-    // Parse Q-Table
-    QStringList qTableLines = lines.mid(qTableStart+2);
-    qTable->setRowCount(qTableLines.size()-1);
-    qTable->setColumnCount(6); // Adjust as needed Process ID
-    qTable->setHorizontalHeaderLabels({"Process ID", "Priority", "CPU Utilization", "Memory Usage", "Waiting Time", "Burst Time"});
+    long long total = worker->totalSteps();
+    if (total > 0) {
+        progressBar->setValue(static_cast<int>(worker->stepsDone() * 1000 / total));
+    }
 
-    for (int i = 0; i < qTableLines.size()-1; ++i) {
-        QStringList columns = qTableLines[i].split('\t');
-        for (int j = 0; j < columns.size(); ++j) {
-            qTable->setItem(i, j, new QTableWidgetItem(columns[j].trimmed()));
+    if (finished) {
+        refreshTimer->stop();
+        progressBar->setValue(progressBar->maximum());
+        if (worker->stepsDone() == 0) {
+            processExecutionLabel->setText("All processes executed!");
         }
+        playButton->setEnabled(false);
+        nextButton->setEnabled(false);
+        speedInput->setEnabled(false);
     }
+}
+
+// Display one decision point of the simulation
+void MainWindow::displayFrame(const TraceFrame& shown) {
+    processStateModel->setFrame(shown);
+    qValueModel->setFrame(shown);
 
     // Update Execution Label
-    QString executionLine = lines.last();
-    processExecutionLabel->setText(executionLine);
+    if (shown.flags & TRACE_FRAME_LAST) {
+        processExecutionLabel->setText("All processes completed!");
+    } else {
+        // Slots follow arrival order, so name the process by its ID
+        int selected = shown.selected_process;
+        bool known = selected >= 0 && static_cast<uint32_t>(selected) < shown.process_count;
+        processExecutionLabel->setText(
+            QString("Will now execute Process ID: %1").arg(known ? shown.rows[selected].id : selected));
+    }
 }
@@ -3,16 +3,24 @@
 
 #include <QMainWindow>
 #include <QSpinBox>
-#include <QTableWidget>
+#include <QTableView>
 #include <QPushButton>
 #include <QLabel>
 #include <QStackedWidget>
+#include <QComboBox>
+#include <QProgressBar>
+#include <QThread>
+#include <QTimer>
+
+#include "simworker.h"
+#include "tablemodels.h"
 
 class MainWindow : public QMainWindow {
     Q_OBJECT
 
 public:
     MainWindow(QWidget* parent = nullptr);
+    ~MainWindow();
 
 private:
     QStackedWidget* stackedWidget;
@@ -21,23 +29,38 @@ private:
 
     // Base Page
     QSpinBox* processCountInput;
-    QTableWidget* processTable;
+    QTableView* processTable;
+    WorkloadModel* workloadModel;
     QPushButton* simulateButton;
 
     // Simulation Page
     QLabel* processExecutionLabel;
-    QTableWidget* processStatesTable;
-    QTableWidget* qTable;
+    QTableView* processStatesTable;
+    QTableView* qTable;
+    ProcessStateModel* processStateModel;
+    QValueModel* qValueModel;
+    QPushButton* playButton;
     QPushButton* nextButton;
+    QComboBox* speedInput;
+    QProgressBar* progressBar;
 
-    int currentFileIndex;
+    // Simulation running in workerThread; refreshTimer shows its newest
+    // snapshot at display rate
+    QThread* workerThread;
+    SimulationWorker* worker;
+    QTimer* refreshTimer;
+    bool paused;
 
     void setupBasePage();
     void setupSimulationPage();
     void updateTableRows(int rowCount);
     void simulate();
-    void loadNextFile();
-    void parseAndDisplayFile(const QString& content);
+    void stopSimulation();
+    void togglePaused();
+    void changeSpeed(int index);
+    void refresh();
+    void displayFrame(const TraceFrame& shown);
+    void configureTable(QTableView* table);
 };
 
 #endif // MAINWINDOW_H
@@ -0,0 +1,146 @@
+#include "simworker.h"
+
+#include <chrono>
+#include <ctime>
+#include <thread>
+
+#include "q_scheduler.h"
+
+SimulationWorker::SimulationWorker(const std::vector<Process>& processes, QObject* parent)
+    : QObject(parent), sim(), simReady(false), total(0) {
+    simReady = sim_init(&sim, static_cast<int>(processes.size()));
+    for (const Process& p : processes) {
+        if (simReady && !sim_add_process(&sim, p)) {
+            simReady = false;
+        }
+    }
+
+    // One step for the first decision, then one per quantum each
+    // incomplete process needs
+    for (const Process& p : processes) {
+        if (!p.completed) {
+            total += p.burst_time > 0 ? (p.burst_time + TIME_QUANTUM - 1) / TIME_QUANTUM : 1;
+        }
+    }
+    if (total > 0) {
+        total++;
+    }
+
+    for (int slot = 0; slot < SlotCount; ++slot) {
+        freeSlots.push(slot);
+    }
+}
+
+SimulationWorker::~SimulationWorker() {
+    for (TraceFrame& snapshot : snapshots) {
+        trace_frame_free(&snapshot);
+    }
+    sim_free(&sim);
+}
+
+void SimulationWorker::setPaused(bool pause) {
+    std::lock_guard<std::mutex> guard(controlLock);
+    paused = pause;
+    controlChanged.notify_all();
+}
+
+void SimulationWorker::setStepsPerSecond(int rate) {
+    std::lock_guard<std::mutex> guard(controlLock);
+    stepsPerSecond = rate;
+    controlChanged.notify_all();
+}
+
+void SimulationWorker::stepOnce() {
+    std::lock_guard<std::mutex> guard(controlLock);
+    pendingSteps++;
+    controlChanged.notify_all();
+}
+
+void SimulationWorker::stop() {
+    std::lock_guard<std::mutex> guard(controlLock);
+    stopRequested = true;
+    controlChanged.notify_all();
+}
+
+bool SimulationWorker::takeSlot(int& slot) {
+    return readySlots.pop(slot);
+}
+
+void SimulationWorker::releaseSlot(int slot) {
+    freeSlots.push(slot);
+}
+
+// Block while paused with no single step requested.
+// Returns false once the simulation should stop.
+bool SimulationWorker::waitForTurn() {
+    std::unique_lock<std::mutex> guard(controlLock);
+    controlChanged.wait(guard, [this] { return stopRequested || !paused || pendingSteps > 0; });
+    if (stopRequested) {
+        return false;
+    }
+    if (paused) {
+        pendingSteps--;
+    }
+    return true;
+}
+
+// Copy the current step into a free slot for the UI, or drop it if the
+// UI still holds every slot. The final step waits for a slot.
+void SimulationWorker::publish(bool final) {
+    int slot;
+    while (!freeSlots.pop(slot)) {
+        if (!final) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> guard(controlLock);
+            if (stopRequested) {
+                return;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    if (sim_snapshot(&sim, &snapshots[slot])) {
+        readySlots.push(slot);
+    } else {
+        freeSlots.push(slot);
+    }
+}
+
+void SimulationWorker::run() {
+    using Clock = std::chrono::steady_clock;
+
+    sim_seed(&sim, static_cast<uint64_t>(time(nullptr)));
+    Clock::time_point next = Clock::now();
+
+    while (simReady && waitForTurn()) {
+        if (!sim_step(&sim)) {
+            break;
+        }
+        steps.fetch_add(1, std::memory_order_relaxed);
+        publish(sim.finished);
+        if (sim.finished) {
+            break;
+        }
+
+        // Pace the run; a pause or a speed change wakes the wait early
+        std::unique_lock<std::mutex> guard(controlLock);
+        if (stepsPerSecond > 0 && !paused) {
+            Clock::time_point now = Clock::now();
+            next += std::chrono::nanoseconds(1000000000LL / stepsPerSecond);
+            if (next < now) {
+                next = now;
+            }
+            int rate = stepsPerSecond;
+            controlChanged.wait_until(guard, next, [this, rate] {
+                return stopRequested || paused || stepsPerSecond != rate;
+            });
+        } else {
+            next = Clock::now();
+        }
+    }
+
+    finished.store(true, std::memory_order_release);
+    emit done();
+}
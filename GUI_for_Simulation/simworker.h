@@ -0,0 +1,75 @@
+#ifndef SIMWORKER_H
+#define SIMWORKER_H
+
+#include <QObject>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+#include "sim_engine.h"
+#include "spscqueue.h"
+
+// Runs a simulation in its own thread (moveToThread, then run()).
+//
+// Frames reach the UI through a fixed pool of snapshot slots and two
+// lock-free queues: the worker takes a slot from freeSlots, copies the
+// current step into it and pushes it on readySlots; the UI pops ready
+// slots, shows the newest and returns them all with releaseSlot(). When no
+// slot is free the UI is behind and the step is simply not published, so
+// the worker never waits for the UI and the UI only sees a subsample of
+// the steps. The final step is always published.
+class SimulationWorker : public QObject {
+    Q_OBJECT
+
+public:
+    static constexpr int SlotCount = 4;
+
+    explicit SimulationWorker(const std::vector<Process>& processes, QObject* parent = nullptr);
+    ~SimulationWorker() override;
+
+    // Control, callable from any thread
+    void setPaused(bool paused);
+    void setStepsPerSecond(int stepsPerSecond); // 0 runs at full speed
+    void stepOnce();                            // one step while paused
+    void stop();
+
+    // Consumer side of the snapshot queue, UI thread only
+    bool takeSlot(int& slot);
+    void releaseSlot(int slot);
+    const TraceFrame& frame(int slot) const { return snapshots[slot]; }
+
+    long long stepsDone() const { return steps.load(std::memory_order_relaxed); }
+    long long totalSteps() const { return total; }
+    bool isFinished() const { return finished.load(std::memory_order_acquire); }
+
+public slots:
+    void run();
+
+signals:
+    void done();
+
+private:
+    bool waitForTurn();
+    void publish(bool final);
+
+    SimEngine sim;
+    bool simReady;
+    long long total;
+    std::atomic<long long> steps{0};
+    std::atomic<bool> finished{false};
+
+    std::array<TraceFrame, SlotCount> snapshots{};
+    SpscQueue<int, SlotCount> freeSlots;  // UI -> worker
+    SpscQueue<int, SlotCount> readySlots; // worker -> UI
+
+    std::mutex controlLock;
+    std::condition_variable controlChanged;
+    bool paused = false;
+    bool stopRequested = false;
+    int pendingSteps = 0;
+    int stepsPerSecond = 0;
+};
+
+#endif // SIMWORKER_H
@@ -0,0 +1,179 @@
+#include "tablemodels.h"
+
+#include <cstring>
+
+// Workload Model
+WorkloadModel::WorkloadModel(QObject* parent) : QAbstractTableModel(parent) {}
+
+int WorkloadModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(rows.size());
+}
+
+int WorkloadModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : ColumnCount;
+}
+
+QVariant WorkloadModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || (role != Qt::DisplayRole && role != Qt::EditRole)) {
+        return QVariant();
+    }
+    return rows[index.row()][index.column()];
+}
+
+bool WorkloadModel::setData(const QModelIndex& index, const QVariant& value, int role) {
+    if (!index.isValid() || role != Qt::EditRole) {
+        return false;
+    }
+    rows[index.row()][index.column()] = value.toString();
+    emit dataChanged(index, index, {Qt::DisplayRole, Qt::EditRole});
+    return true;
+}
+
+QVariant WorkloadModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    static const QStringList labels = {"ID", "Burst", "Wait", "Priority", "CPU%", "Memory%", "Completed", "Arrival"};
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Horizontal) {
+        return labels.value(section);
+    }
+    return section + 1;
+}
+
+Qt::ItemFlags WorkloadModel::flags(const QModelIndex& index) const {
+    return QAbstractTableModel::flags(index) | Qt::ItemIsEditable;
+}
+
+// Grow or shrink the workload, keeping what was typed in the rows that stay.
+// New rows start with their ID filled in.
+void WorkloadModel::setProcessCount(int count) {
+    int current = static_cast<int>(rows.size());
+    if (count > current) {
+        beginInsertRows(QModelIndex(), current, count - 1);
+        rows.resize(count);
+        for (int i = current; i < count; ++i) {
+            rows[i][0] = QString::number(i);
+        }
+        endInsertRows();
+    } else if (count < current) {
+        beginRemoveRows(QModelIndex(), count, current - 1);
+        rows.resize(count);
+        endRemoveRows();
+    }
+}
+
+// Parse one row, empty cells reading as zero
+Process WorkloadModel::process(int row) const {
+    const auto& cells = rows[row];
+    Process p;
+    p.id = cells[0].trimmed().toInt();
+    p.burst_time = cells[1].trimmed().toInt();
+    p.waiting_time = cells[2].trimmed().toInt();
+    p.system_priority = cells[3].trimmed().toInt();
+    p.cpu_utilization = cells[4].trimmed().toFloat();
+    p.memory_usage = cells[5].trimmed().toFloat();
+    p.completed = cells[6].trimmed() == "true";
+    p.arrival_time = cells[7].trimmed().toInt();
+    return p;
+}
+
+// Frame Model
+FrameModel::FrameModel(QObject* parent) : QAbstractTableModel(parent) {}
+
+int FrameModel::rowCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(rows.size());
+}
+
+QVariant FrameModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    return cell(rows[index.row()], index.column());
+}
+
+QVariant FrameModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (role != Qt::DisplayRole) {
+        return QVariant();
+    }
+    if (orientation == Qt::Horizontal) {
+        return headers().value(section);
+    }
+    return section + 1;
+}
+
+void FrameModel::setFrame(const TraceFrame& frame) {
+    int count = static_cast<int>(frame.process_count);
+    int current = static_cast<int>(rows.size());
+
+    if (count != current) {
+        // A new workload: reset rather than diff
+        beginResetModel();
+        rows.assign(frame.rows, frame.rows + count);
+        endResetModel();
+        return;
+    }
+
+    // Signal each run of consecutive changed rows as one range
+    int lastColumn = columnCount() - 1;
+    int first = -1;
+    for (int i = 0; i <= count; ++i) {
+        bool changed = i < count && rowChanged(rows[i], frame.rows[i]);
+        if (changed) {
+            rows[i] = frame.rows[i];
+            if (first < 0) {
+                first = i;
+            }
+        } else if (first >= 0) {
+            emit dataChanged(index(first, 0), index(i - 1, lastColumn), {Qt::DisplayRole});
+            first = -1;
+        }
+    }
+}
+
+// Process State Model
+int ProcessStateModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : 7;
+}
+
+QStringList ProcessStateModel::headers() const {
+    return {"ID", "Burst", "Wait", "Priority", "CPU%", "Memory%", "Completed"};
+}
+
+QVariant ProcessStateModel::cell(const TraceRow& p, int column) const {
+    switch (column) {
+    case 0: return p.id;
+    case 1: return p.burst_time;
+    case 2: return p.waiting_time;
+    case 3: return p.system_priority;
+    case 4: return QString::number(p.cpu_utilization, 'f', 2);
+    case 5: return QString::number(p.memory_usage, 'f', 2);
+    case 6: return p.completed ? "Yes" : "No";
+    }
+    return QVariant();
+}
+
+bool ProcessStateModel::rowChanged(const TraceRow& a, const TraceRow& b) const {
+    return a.id != b.id || a.burst_time != b.burst_time || a.waiting_time != b.waiting_time ||
+           a.system_priority != b.system_priority || a.cpu_utilization != b.cpu_utilization ||
+           a.memory_usage != b.memory_usage || a.completed != b.completed;
+}
+
+// Q-Value Model
+int QValueModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : 1 + MAX_STATES;
+}
+
+QStringList QValueModel::headers() const {
+    return {"Process ID", "Priority", "CPU Utilization", "Memory Usage", "Waiting Time", "Burst Time"};
+}
+
+QVariant QValueModel::cell(const TraceRow& row, int column) const {
+    if (column == 0) {
+        return QString("Process %1").arg(row.slot);
+    }
+    return QString::number(row.q[column - 1], 'f', 2);
+}
+
+bool QValueModel::rowChanged(const TraceRow& a, const TraceRow& b) const {
+    return a.slot != b.slot || std::memcmp(a.q, b.q, sizeof(a.q)) != 0;
+}
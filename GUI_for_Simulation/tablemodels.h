@@ -0,0 +1,88 @@
+#ifndef TABLEMODELS_H
+#define TABLEMODELS_H
+
+#include <QAbstractTableModel>
+#include <QString>
+#include <QStringList>
+#include <array>
+#include <vector>
+
+#include "sim_engine.h"
+
+// Editable workload on the base page, one process per row, kept as the
+// text the user typed until the simulation starts.
+class WorkloadModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    static constexpr int ColumnCount = 8;
+
+    explicit WorkloadModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    bool setData(const QModelIndex& index, const QVariant& value, int role = Qt::EditRole) override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+    void setProcessCount(int count);
+    Process process(int row) const;
+
+private:
+    std::vector<std::array<QString, ColumnCount>> rows;
+};
+
+// Shows one simulation frame. setFrame() copies the new frame and only
+// signals the rows that differ from the one shown, so views repaint just
+// those rows however large the table is.
+class FrameModel : public QAbstractTableModel {
+    Q_OBJECT
+
+public:
+    explicit FrameModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void setFrame(const TraceFrame& frame);
+
+protected:
+    virtual QStringList headers() const = 0;
+    virtual QVariant cell(const TraceRow& row, int column) const = 0;
+    // True if the columns this model shows differ between a and b
+    virtual bool rowChanged(const TraceRow& a, const TraceRow& b) const = 0;
+
+    std::vector<TraceRow> rows;
+};
+
+// Current Process States: the features of every process
+class ProcessStateModel : public FrameModel {
+    Q_OBJECT
+
+public:
+    using FrameModel::FrameModel;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+protected:
+    QStringList headers() const override;
+    QVariant cell(const TraceRow& row, int column) const override;
+    bool rowChanged(const TraceRow& a, const TraceRow& b) const override;
+};
+
+// Q-Table: the Q values of every process
+class QValueModel : public FrameModel {
+    Q_OBJECT
+
+public:
+    using FrameModel::FrameModel;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+
+protected:
+    QStringList headers() const override;
+    QVariant cell(const TraceRow& row, int column) const override;
+    bool rowChanged(const TraceRow& a, const TraceRow& b) const override;
+};
+
+#endif // TABLEMODELS_H
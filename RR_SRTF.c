@@ -3,14 +3,8 @@
 #include <unistd.h>
 #include <sys/types.h>
 #include <sys/wait.h>
-#include <limits.h>
-
-struct Process {
-    int pid;
-    int burst_time;
-    int arrival_time;
-    int waiting_time;
-};
+#include "baseline_schedulers.h"
+#include "workload.h"
 
 void initialize_processes(struct Process processes[], int n) {
     for (int i = 0; i < n; i++) {
@@ -32,106 +26,65 @@ void initialize_processes(struct Process processes[], int n) {
     }
 }
 
-void round_robin(struct Process processes[], int n, int quantum) {
-    int remaining_burst[n];
-    int time = 0, done;
-
-    for (int i = 0; i < n; i++) {
-        remaining_burst[i] = processes[i].burst_time;
-        processes[i].waiting_time = 0;
+// Take the processes, with their arrival times, from a CSV or compiled workload
+struct Process *load_processes(const char *path, int *n) {
+    ProcessStore store;
+    if (!store_init(&store, 0)) {
+        perror("Error allocating process store");
+        exit(EXIT_FAILURE);
     }
-
-    while (1) {
-        done = 1;
-
-        for (int i = 0; i < n; i++) {
-            if (processes[i].arrival_time <= time && remaining_burst[i] > 0) {
-                done = 0;
-
-                if (remaining_burst[i] > quantum) {
-                    time += quantum;
-                    remaining_burst[i] -= quantum;
-                } else {
-                    time += remaining_burst[i];
-                    processes[i].waiting_time = time - processes[i].burst_time - processes[i].arrival_time;
-                    remaining_burst[i] = 0;
-                }
-            }
-        }
-
-        if (done == 1)
-            break;
-
-        int no_ready_process = 1;
-        for (int i = 0; i < n; i++) {
-            if (processes[i].arrival_time <= time && remaining_burst[i] > 0) {
-                no_ready_process = 0;
-                break;
-            }
+    WorkloadStats stats;
+    if (!workload_load(&store, path, 0, &stats)) {
+        if (stats.bad_lines == 0) {
+            perror("Error reading workload");
         }
-
-        if (no_ready_process)
-            time++;
+        exit(EXIT_FAILURE);
     }
-}
 
-void srtf_scheduling(struct Process processes[], int n) {
-    int remaining_time[n];
-    int time = 0, completed = 0, shortest = -1, min_remaining = INT_MAX;
-    int is_completed[n];
-
-    for (int i = 0; i < n; i++) {
-        remaining_time[i] = processes[i].burst_time;
+    struct Process *processes = malloc((size_t)(store.count > 0 ? store.count : 1) * sizeof(struct Process));
+    if (processes == NULL) {
+        perror("Error allocating processes");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < store.count; i++) {
+        processes[i].pid = store.id[i];
+        processes[i].burst_time = store.burst_time[i];
+        processes[i].arrival_time = store.arrival_time[i];
         processes[i].waiting_time = 0;
-        is_completed[i] = 0;
     }
+    *n = store.count;
+    store_free(&store);
+    return processes;
+}
 
-    while (completed != n) {
-        for (int i = 0; i < n; i++) {
-            if (processes[i].arrival_time <= time && !is_completed[i] && remaining_time[i] < min_remaining) {
-                min_remaining = remaining_time[i];
-                shortest = i;
-            }
-        }
-
-        if (shortest == -1) {
-            time++;
-            continue;
-        }
-
-        remaining_time[shortest]--;
-        if (remaining_time[shortest] == 0) {
-            completed++;
-            is_completed[shortest] = 1;
-            min_remaining = INT_MAX;
+int main(int argc, char *argv[]) {
+    int n, quantum;
+    struct Process *processes;
 
-            processes[shortest].waiting_time = time + 1 - processes[shortest].burst_time - processes[shortest].arrival_time;
+    if (argc > 3) {
+        fprintf(stderr, "Usage: %s [workload_file [quantum]]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (argc > 1) {
+        processes = load_processes(argv[1], &n);
+    } else {
+        printf("Enter the number of processes: ");
+        scanf("%d", &n);
+
+        processes = malloc((size_t)(n > 0 ? n : 1) * sizeof(struct Process));
+        if (processes == NULL) {
+            perror("Error allocating processes");
+            exit(EXIT_FAILURE);
         }
-
-        time++;
+        initialize_processes(processes, n);
     }
-}
 
-float calculate_average_waiting_time(struct Process processes[], int n) {
-    float total_waiting_time = 0;
-    for (int i = 0; i < n; i++) {
-        total_waiting_time += processes[i].waiting_time;
+    if (argc > 2) {
+        quantum = atoi(argv[2]);
+    } else {
+        printf("\nEnter quantum time for Round-Robin scheduling: ");
+        scanf("%d", &quantum);
     }
-    return total_waiting_time / n;
-}
-
-int main() {
-    int n, quantum;
-
-    printf("Enter the number of processes: ");
-    scanf("%d", &n);
-
-    struct Process processes[n];
-
-    initialize_processes(processes, n);
-
-    printf("\nEnter quantum time for Round-Robin scheduling: ");
-    scanf("%d", &quantum);
 
     round_robin(processes, n, quantum);
     float avg_waiting_rr = calculate_average_waiting_time(processes, n);
@@ -141,6 +94,7 @@ int main() {
     float avg_waiting_srtf = calculate_average_waiting_time(processes, n);
     printf("\nSRTF Scheduling Average Waiting Time: %.2f\n", avg_waiting_srtf);
 
+    free(processes);
     return 0;
 }
 
@@ -2,263 +2,124 @@
 #include <stdlib.h>
 #include <time.h>
 #include <stdbool.h>
-
-#define MAX_PROCESSES 10
-#define MAX_STATES 5
-#define TIME_QUANTUM 2
-#define LEARNING_RATE 0.2
-#define DISCOUNT_FACTOR 0.9
-// #define EPSILON 0.1 // Exploration factor
-
-// Process structure
-typedef struct {
-    int id;
-    int burst_time;
-    int waiting_time;
-    int system_priority;
-    float cpu_utilization;
-    float memory_usage;
-    bool completed;
-} Process;
+#include "q_scheduler.h"
+#include "sim_engine.h"
+#include "sim_log.h"
+#include "trace.h"
 
 // Global variables
-Process processes[MAX_PROCESSES];
-float Q_table[MAX_PROCESSES][MAX_STATES];
-int num_processes;
+SimEngine sim;
+SimLog logger;
+TraceWriter trace;
 
 // Function prototypes
-void initialize_processes();
-void initialize_q_table();
-int select_action();
-void update_q_table();
-float calculate_reward(Process p);
-void update_state(int process_id);
-void remove_completed_process(int process_id);
+void initialize_processes(uint64_t seed);
 void display_processes();
 void display_q_table();
-void save_to_file(int iteration, int process_id,int last);
+float calculate_avg_waiting_time();
+void save_to_file(int process_id, int last);
+void on_step(const SimEngine *engine, void *user_data);
+
+int main(int argc, char* argv[]) {
+    LogLevel level = log_level_from_args(&argc, argv, log_level_from_env(LOG_FULL));
+    uint64_t seed = rng_seed_from_args(&argc, argv, rng_seed_from_env((uint64_t)time(NULL)));
+    if (!trace_open(&trace, TRACE_DEFAULT_FILE, TRACE_DEFAULT_KEYFRAME_INTERVAL)) {
+        perror("Error opening trace file");
+        exit(EXIT_FAILURE);
+    }
+    if (!log_start(&logger, level, stdout, &trace)) {
+        perror("Error starting logger");
+        exit(EXIT_FAILURE);
+    }
 
-int main() {
-    srand(time(NULL));
-    
-    initialize_processes();
-    initialize_q_table();
+    initialize_processes(seed);
 
-    printf("Initial Processes:\n");
+    log_printf(&logger, LOG_FULL, "Initial Processes:\n");
     display_processes();
 
-    int iteration = 0;
-
-    while (1) {
-        // Checking if all processes are completed
-        bool all_completed = true;
-        for (int i = 0; i < num_processes; i++) {
-            if (!processes[i].completed) {
-                all_completed = false;
-                break;
-            }
-        }
-        if (all_completed) break;
-        
-        // Calculating reward and updating Q-table
-        update_q_table();
-
-        // Selecting the process to schedule based on Q-value
-        int selected_process = select_action();
-        Process *p = &processes[selected_process];
-
-        // Saving the current state and Q-table into a  txt file
-        save_to_file(iteration++, selected_process,0);
-
-        // Executing the process for the time quantum
-        printf("\nExecuting Process ID: %d\n", p->id);
-        p->burst_time -= TIME_QUANTUM;
-        if (p->burst_time <= 0) {
-            p->burst_time = 0;
-            p->completed = true;
-        }
-
-        // Updating waiting times of other processes
-        for (int i = 0; i < num_processes; i++) {
-            if (i != selected_process && !processes[i].completed) {
-                processes[i].waiting_time += TIME_QUANTUM;
-            }
-        }
-
-        // Updating state variables (random values for dynamic simulation)
-        update_state(selected_process);
-
-        all_completed = true;
-        for (int i = 0; i < num_processes; i++) {
-            if (!processes[i].completed) {
-                all_completed = false;
-                break;
-            }
-        }
-        if (all_completed){
-            // Saving the last final iteration result
-            save_to_file(iteration++, selected_process,1);
-        }
+    // Every step runs the selected process, updates the Q-table and picks
+    // the next one; on_step() reports it
+    sim_set_step_callback(&sim, on_step, NULL);
+    while (sim_step(&sim)) {
+    }
 
-        // Removing completed process from Q-table
-        if (p->completed) {
-            remove_completed_process(selected_process);
-        }
+    log_printf(&logger, LOG_SUMMARY, "\nAll processes completed!\n");
+    log_printf(&logger, LOG_SUMMARY, "Average Waiting Time: %.2f\n", calculate_avg_waiting_time());
+    log_printf(&logger, LOG_SUMMARY, "Saved output to %s\n", TRACE_DEFAULT_FILE);
 
-        // Displaying updated process table
-        display_processes();
+    // Writes out the queued trace frames before the index goes after them
+    bool trace_ok = log_stop(&logger);
+    if (!trace_close(&trace) || !trace_ok) {
+        perror("Error writing trace file");
+        exit(EXIT_FAILURE);
     }
-
-    printf("\nAll processes completed!\n");
+    sim_free(&sim);
     return 0;
 }
 
-void initialize_processes() {
-    printf("Enter the number of processes (max %d): ", MAX_PROCESSES);
-    scanf("%d", &num_processes);
-    for (int i = 0; i < num_processes; i++) {
-        processes[i].id = i;
-        processes[i].burst_time = rand() % 20 + 1; 
-        processes[i].waiting_time = 0;
-        processes[i].system_priority = rand() % 10 + 1;
-        processes[i].cpu_utilization = (float)(rand() % 100) / 100.0;
-        processes[i].memory_usage = (float)(rand() % 100) / 100.0;
-        processes[i].completed = false;
+void initialize_processes(uint64_t seed) {
+    int num_processes;
+    if (log_enabled(&logger, LOG_STEP)) {
+        printf("Enter the number of processes: ");
     }
-}
+    scanf("%d", &num_processes);
 
-void initialize_q_table() {
-    for (int i = 0; i < MAX_PROCESSES; i++) {
-        for (int j = 0; j < MAX_STATES; j++) {
-            Q_table[i][j] = 0.0;
-        }
+    if (!sim_init(&sim, num_processes)) {
+        perror("Error allocating process store");
+        exit(EXIT_FAILURE);
     }
-}
+    sim_seed(&sim, seed);
+    if (num_processes <= 0) return;
 
-int select_action() {
-    float max_q_value = -1e9;
-    int best_process = -1;
-
-    for (int i = 0; i < num_processes; i++) {
-        if (!processes[i].completed) {
-            float q_value = 0;
-            for (int j = 0; j < MAX_STATES; j++) {
-                q_value += Q_table[i][j];
-            }
-            if (q_value > max_q_value) {
-                max_q_value = q_value;
-                best_process = i;
-            }
-        }
+    // The workload and the state changes come from the same stream
+    Process *processes = malloc((size_t)num_processes * sizeof(Process));
+    if (processes == NULL) {
+        perror("Error allocating processes");
+        exit(EXIT_FAILURE);
     }
-
-    return best_process;
-}
-
-void update_q_table() {
+    generate_processes(processes, num_processes, 0, &sim.rng);
     for (int i = 0; i < num_processes; i++) {
-        if (processes[i].completed) continue;
-
-        // Calculating reward for the current process
-        float reward = calculate_reward(processes[i]);
-
-        for (int j = 0; j < MAX_STATES; j++) {
-            float max_next_q = 0;
-            for (int k = 0; k < MAX_STATES; k++) {
-                if (Q_table[i][k] > max_next_q) {
-                    max_next_q = Q_table[i][k];
-                }
-            }
-            Q_table[i][j] = Q_table[i][j] + LEARNING_RATE * (reward + DISCOUNT_FACTOR * max_next_q - Q_table[i][j]);
-        }
+        sim_add_process(&sim, processes[i]);
     }
-}
-
-
-float calculate_reward(Process p) {
-    float w1 = 0.35, w2 = 0.2, w3 = 0.2, w4 = 0.15, w5 = 0.05;
-
-    float reward = (w1 * (float)p.system_priority) + 
-                   (w2 * -(float)p.burst_time) + 
-                   (w3 * (float)p.waiting_time) + 
-                   (w4 * -(float)p.cpu_utilization) + 
-                   (w5 * (float)p.memory_usage);
-
-    return reward;
-}
-
-void update_state(int process_id) {
-    processes[process_id].system_priority = rand() % 10 + 1;
-    processes[process_id].cpu_utilization = (float)(rand() % 100) / 100.0;
-    processes[process_id].memory_usage = (float)(rand() % 100) / 100.0;
-}
-
-void remove_completed_process(int process_id) {
-    for (int i = 0; i < MAX_STATES; i++) {
-        Q_table[process_id][i] = 0.0;
-    }
-    printf("Process ID %d completed and removed from Q-table.\n", process_id);
+    free(processes);
 }
 
 void display_processes() {
-    printf("\nCurrent Process States:\n");
-    printf("ID\tBurst\tWait\tPriority\tCPU%%\tMemory%%\tCompleted\n");
-    for (int i = 0; i < num_processes; i++) {
-        printf("%d\t%d\t%d\t%d\t\t%.2f\t%.2f\t%s\n",
-               processes[i].id, processes[i].burst_time, processes[i].waiting_time,
-               processes[i].system_priority, processes[i].cpu_utilization,
-               processes[i].memory_usage, processes[i].completed ? "Yes" : "No");
-    }
+    log_processes(&logger, LOG_FULL, &sim.store, LOG_SHOW_PROCESSES);
 }
 
 void display_q_table() {
-    printf("\nQ-Table:\n");
-    for (int i = 0; i < num_processes; i++) {
-        printf("Process %d: ", i);
-        for (int j = 0; j < MAX_STATES; j++) {
-            printf("%.2f ", Q_table[i][j]);
-        }
-        printf("\n");
-    }
+    log_processes(&logger, LOG_FULL, &sim.store, LOG_SHOW_Q_TABLE);
 }
 
 
-void save_to_file(int iteration, int process_id,int last) {
-    char filename[50];
-    sprintf(filename, "output_iteration_%d.txt", iteration);
-    FILE *file = fopen(filename, "w");
-
-    if (file == NULL) {
-        perror("Error opening file");
-        exit(EXIT_FAILURE);
-    }
-
-    fprintf(file, "Current Process States:\n");
-    fprintf(file, "ID\tBurst\tWait\tPriority\tCPU%%\tMemory%%\tCompleted\n");
-    for (int i = 0; i < num_processes; i++) {
-        fprintf(file, "%d\t%d\t\t%d\t\t%d\t\t\t%.2f\t%.2f\t%s\n",
-                processes[i].id, processes[i].burst_time, processes[i].waiting_time,
-                processes[i].system_priority, processes[i].cpu_utilization,
-                processes[i].memory_usage, processes[i].completed ? "Yes" : "No");
+// Report one step: the process that just ran, the process table after it,
+// and the new decision point for the trace
+void on_step(const SimEngine *engine, void *user_data) {
+    (void)user_data;
+    int executed = engine->executed;
+    if (executed >= 0) {
+        log_printf(&logger, LOG_STEP, "\nExecuting Process ID: %d\n", engine->store.id[executed]);
+        if (engine->store.completed[executed]) {
+            log_printf(&logger, LOG_STEP, "Process ID %d completed and removed from Q-table.\n", executed);
+        }
+        display_processes();
     }
 
-    // Q-table headers
-    fprintf(file, "\nQ-Table:\n");
-    fprintf(file, "Process ID\tPriority\tCPU Utilization\tMemory Usage\tWaiting Time\tBurst Time\n");
+    // Appending the current state and Q-table to the trace
+    save_to_file(engine->selected, engine->finished);
+}
 
-    for (int i = 0; i < num_processes; i++) {
-        fprintf(file, "Process %d: ", i);
-        // Writing the values of the Q-table with respect to the actual states
-        fprintf(file, " %.2f\t\t%.2f\t\t\t%.2f\t\t\t%.2f\t\t\t%.2f\t\n",
-                Q_table[i][0], Q_table[i][1], Q_table[i][2], Q_table[i][3], Q_table[i][4]);
-    }
-    if(last==0){
-        fprintf(file, "\nWill now execute Process ID: %d\n", process_id);
-    }
-    else {
-        fprintf(file, "\nAll processes completed!\n");
+float calculate_avg_waiting_time() {
+    int total_waiting_time = 0;
+    for (int i = 0; i < sim.store.count; i++) {
+        total_waiting_time += store_waiting_time(&sim.store, i);
     }
+    return (float)total_waiting_time / sim.store.count;
+}
 
-    fclose(file);
-    printf("Saved output to %s\n", filename);
+// Queue one frame for the trace; the logger thread writes it and
+// trace_to_text turns the trace back into the per-iteration text tables
+void save_to_file(int process_id, int last) {
+    log_trace_frame(&logger, &sim.store, process_id, last != 0);
 }
@@ -0,0 +1,213 @@
+#include <stdbool.h>
+#include <stdlib.h>
+#include "baseline_schedulers.h"
+
+// Both schedulers admit processes in (arrival time, index) order
+typedef struct {
+    int arrival_time;
+    int process;
+} Arrival;
+
+static int compare_arrival(const void *a, const void *b) {
+    const Arrival *x = a, *y = b;
+    if (x->arrival_time != y->arrival_time) return x->arrival_time < y->arrival_time ? -1 : 1;
+    return (x->process > y->process) - (x->process < y->process);
+}
+
+/* Round-robin with a FIFO ready queue. Arrivals are sorted once and merged
+ * into the queue as the clock passes them; a process whose slice expires
+ * goes behind everything that arrived during that slice. The queue is a
+ * ring buffer of n slots, since a process is queued at most once, so each
+ * slice costs O(1) and an idle clock jumps straight to the next arrival. */
+
+typedef struct {
+    int *slot;
+    int head;
+    int size;
+    int capacity;
+} ReadyRing;
+
+static void ring_push(ReadyRing *r, int process) {
+    int tail = r->head + r->size;
+    if (tail >= r->capacity) tail -= r->capacity;
+    r->slot[tail] = process;
+    r->size++;
+}
+
+static int ring_pop(ReadyRing *r) {
+    int process = r->slot[r->head];
+    if (++r->head == r->capacity) r->head = 0;
+    r->size--;
+    return process;
+}
+
+// Returns the number of time slices dispatched, or -1 if quantum is not
+// positive or out of memory.
+long round_robin(struct Process processes[], int n, int quantum) {
+    if (quantum < 1) return -1;
+
+    int *remaining = malloc((size_t)n * sizeof(int));
+    Arrival *arrivals = malloc((size_t)n * sizeof(Arrival));
+    int *ring = malloc((size_t)n * sizeof(int));
+    if (n > 0 && (remaining == NULL || arrivals == NULL || ring == NULL)) {
+        free(remaining);
+        free(arrivals);
+        free(ring);
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        remaining[i] = processes[i].burst_time;
+        processes[i].waiting_time = 0;
+        arrivals[i] = (Arrival){processes[i].arrival_time, i};
+    }
+    qsort(arrivals, (size_t)n, sizeof(Arrival), compare_arrival);
+
+    ReadyRing ready = {ring, 0, 0, n};
+    long decisions = 0;
+    int time = 0, completed = 0, next_arrival = 0;
+
+    while (completed != n) {
+        // Idle: jump to the next arrival
+        if (ready.size == 0 && arrivals[next_arrival].arrival_time > time) {
+            time = arrivals[next_arrival].arrival_time;
+        }
+        while (next_arrival < n && arrivals[next_arrival].arrival_time <= time) {
+            ring_push(&ready, arrivals[next_arrival++].process);
+        }
+
+        int current = ring_pop(&ready);
+        decisions++;
+
+        int slice = remaining[current] > quantum ? quantum : remaining[current];
+        time += slice;
+        remaining[current] -= slice;
+
+        // Processes that arrived during the slice queue ahead of it
+        while (next_arrival < n && arrivals[next_arrival].arrival_time <= time) {
+            ring_push(&ready, arrivals[next_arrival++].process);
+        }
+
+        if (remaining[current] > 0) {
+            ring_push(&ready, current);
+        } else {
+            completed++;
+            processes[current].waiting_time = time - processes[current].burst_time - processes[current].arrival_time;
+        }
+    }
+
+    free(remaining);
+    free(arrivals);
+    free(ring);
+    return decisions;
+}
+
+/* SRTF as a discrete-event simulation. The running process can only be
+ * preempted when something arrives, so the clock jumps from one arrival or
+ * completion to the next instead of ticking one time unit at a time.
+ * Processes become ready in arrival order (sorted once) and the ready set
+ * is a min-heap on remaining time, ties going to the lower index like the
+ * old per-tick scan. Cost is O((n + events) log n). */
+
+typedef struct {
+    int *slot;           // heap position -> process index
+    const int *remaining;
+    int size;
+} ReadyHeap;
+
+static bool ready_before(const ReadyHeap *h, int a, int b) {
+    if (h->remaining[a] != h->remaining[b]) return h->remaining[a] < h->remaining[b];
+    return a < b;
+}
+
+static void ready_push(ReadyHeap *h, int process) {
+    int i = h->size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!ready_before(h, process, h->slot[parent])) break;
+        h->slot[i] = h->slot[parent];
+        i = parent;
+    }
+    h->slot[i] = process;
+}
+
+static int ready_pop(ReadyHeap *h) {
+    int top = h->slot[0];
+    int last = h->slot[--h->size];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= h->size) break;
+        if (child + 1 < h->size && ready_before(h, h->slot[child + 1], h->slot[child])) child++;
+        if (!ready_before(h, h->slot[child], last)) break;
+        h->slot[i] = h->slot[child];
+        i = child;
+    }
+    if (h->size > 0) h->slot[i] = last;
+    return top;
+}
+
+// Returns the number of dispatches (one per arrival or completion that
+// picks a process to run), or -1 if out of memory.
+long srtf_scheduling(struct Process processes[], int n) {
+    int *remaining = malloc((size_t)n * sizeof(int));
+    Arrival *arrivals = malloc((size_t)n * sizeof(Arrival));
+    int *heap = malloc((size_t)n * sizeof(int));
+    if (n > 0 && (remaining == NULL || arrivals == NULL || heap == NULL)) {
+        free(remaining);
+        free(arrivals);
+        free(heap);
+        return -1;
+    }
+
+    for (int i = 0; i < n; i++) {
+        remaining[i] = processes[i].burst_time;
+        processes[i].waiting_time = 0;
+        arrivals[i] = (Arrival){processes[i].arrival_time, i};
+    }
+    qsort(arrivals, (size_t)n, sizeof(Arrival), compare_arrival);
+
+    ReadyHeap ready = {heap, remaining, 0};
+    long decisions = 0;
+    int time = 0, completed = 0, next_arrival = 0;
+
+    while (completed != n) {
+        // Idle: jump to the next arrival
+        if (ready.size == 0 && arrivals[next_arrival].arrival_time > time) {
+            time = arrivals[next_arrival].arrival_time;
+        }
+        while (next_arrival < n && arrivals[next_arrival].arrival_time <= time) {
+            ready_push(&ready, arrivals[next_arrival++].process);
+        }
+
+        int shortest = ready_pop(&ready);
+        decisions++;
+
+        // Run until it completes or the next arrival may preempt it
+        int finish = time + remaining[shortest];
+        if (next_arrival < n && arrivals[next_arrival].arrival_time < finish) {
+            int until = arrivals[next_arrival].arrival_time;
+            remaining[shortest] -= until - time;
+            time = until;
+            ready_push(&ready, shortest);
+        } else {
+            remaining[shortest] = 0;
+            time = finish;
+            completed++;
+            processes[shortest].waiting_time = time - processes[shortest].burst_time - processes[shortest].arrival_time;
+        }
+    }
+
+    free(remaining);
+    free(arrivals);
+    free(heap);
+    return decisions;
+}
+
+float calculate_average_waiting_time(struct Process processes[], int n) {
+    float total_waiting_time = 0;
+    for (int i = 0; i < n; i++) {
+        total_waiting_time += processes[i].waiting_time;
+    }
+    return total_waiting_time / n;
+}
@@ -0,0 +1,22 @@
+#ifndef BASELINE_SCHEDULERS_H
+#define BASELINE_SCHEDULERS_H
+
+// Classic schedulers the Q-table scheduler is compared against.
+// Both fill in waiting_time for every process and return the number of
+// scheduling decisions they made: one per time slice for round_robin, one
+// per dispatch at an arrival or completion for srtf_scheduling. They
+// return -1 if they run out of memory, or round_robin's quantum is not
+// positive.
+
+struct Process {
+    int pid;
+    int burst_time;
+    int arrival_time;
+    int waiting_time;
+};
+
+long round_robin(struct Process processes[], int n, int quantum);
+long srtf_scheduling(struct Process processes[], int n);
+float calculate_average_waiting_time(struct Process processes[], int n);
+
+#endif // BASELINE_SCHEDULERS_H
@@ -0,0 +1,493 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "baseline_schedulers.h"
+#include "q_kernel.h"
+#include "q_scheduler.h"
+#include "sim_engine.h"
+#include "workload.h"
+
+// Headless benchmark: runs seeded episodes of every policy on all cores
+// and reports waiting and turnaround statistics with 95% confidence
+// intervals, decision throughput and wall time.
+//
+// Episode e uses the e-th jump-ahead stream of the base seed: it draws one
+// workload from the stream, runs every policy on it, and the Q-table
+// engine continues on the same stream. With --workload every episode runs
+// the same compiled workload instead, mapped once and shared by all
+// threads, and only the Q-table engine's stream differs. Processes arrive
+// at the times the workload gives, or, with --arrival-rate, as a Poisson
+// process drawn from the episode's stream; turnaround counts from arrival.
+// With --policy every Q-table episode starts from the rows of a saved
+// Q policy snapshot, which the threads share without learning into it.
+// Results are stored per episode, so they do not depend on the number of
+// threads.
+
+#define Z_95 1.96
+
+enum { POLICY_Q_TABLE, POLICY_RR, POLICY_SRTF, POLICY_COUNT };
+
+static const char *policy_names[POLICY_COUNT] = {"q_table", "round_robin", "srtf"};
+
+typedef struct {
+    int episodes;
+    int processes;
+    int threads;
+    int quantum;
+    uint64_t seed;
+    double arrival_rate; // 0: keep the workload's arrival times
+    const char *json_path;
+    const char *csv_path;
+    const char *workload_path;
+    const char *policy_path;
+} BenchConfig;
+
+// Statistics of one policy on one episode
+typedef struct {
+    double waiting_mean, waiting_p50, waiting_p99;
+    double turnaround_mean, turnaround_p50, turnaround_p99;
+    double wall_seconds;
+    long decisions;
+} EpisodeResult;
+
+typedef struct {
+    const BenchConfig *config;
+    const Rng *streams;                     // [episode]
+    const WorkloadFile *workload;           // NULL: generate one per episode
+    QPolicy *policy;                        // warm start, NULL for none
+    EpisodeResult (*results)[POLICY_COUNT]; // [episode][policy]
+    atomic_int next_episode;
+} BenchState;
+
+typedef struct {
+    double mean;
+    double ci95; // half-width of the 95% confidence interval of the mean
+} Estimate;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted values
+static double percentile(const double *sorted, int n, double p) {
+    int rank = (int)ceil(p * n);
+    if (rank < 1) rank = 1;
+    return sorted[rank - 1];
+}
+
+static void summarize(double *values, int n, double *mean, double *p50, double *p99) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) sum += values[i];
+    qsort(values, (size_t)n, sizeof(double), compare_doubles);
+    *mean = sum / n;
+    *p50 = percentile(values, n, 0.50);
+    *p99 = percentile(values, n, 0.99);
+}
+
+/* ---------------------------------------------------------------------- */
+/* Policies                                                                */
+/* ---------------------------------------------------------------------- */
+
+typedef struct {
+    double *completion;
+    int clock; // simulation time at the previous decision
+} QTableEpisode;
+
+// Record when each process finishes: one quantum after the decision that
+// scheduled it. By the time the step reports, the clock may already have
+// jumped ahead to the next arrival.
+static void on_q_table_step(const SimEngine *sim, void *user_data) {
+    QTableEpisode *episode = user_data;
+    int executed = sim->executed;
+
+    if (executed >= 0 && sim->store.completed[executed]) {
+        episode->completion[executed] = episode->clock + TIME_QUANTUM;
+    }
+    episode->clock = sim->time;
+}
+
+// Waiting time is the simulator's own accounting: TIME_QUANTUM for every
+// step a process spends ready but not selected. Store slots follow
+// admission order, so the results are per slot, not per workload entry.
+static long run_q_table(const Process *workload, int n, const Rng *rng, QPolicy *policy,
+                        double *waiting, double *turnaround) {
+    SimEngine sim;
+    if (!sim_init(&sim, n)) {
+        perror("Error allocating simulation");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++) {
+        sim_add_process(&sim, workload[i]);
+    }
+    sim_set_rng(&sim, rng);
+    sim_set_policy(&sim, policy, false);
+
+    QTableEpisode episode = {turnaround, 0};
+    sim_set_step_callback(&sim, on_q_table_step, &episode);
+    long decisions = 0;
+    while (sim_step(&sim)) {
+        decisions++;
+    }
+
+    for (int i = 0; i < n; i++) {
+        waiting[i] = store_waiting_time(&sim.store, i);
+        turnaround[i] -= sim.store.arrival_time[i];
+    }
+    sim_free(&sim);
+    return decisions;
+}
+
+static long run_baseline(int policy, const Process *workload, int n, int quantum,
+                         struct Process *processes, double *waiting, double *turnaround) {
+    for (int i = 0; i < n; i++) {
+        processes[i].pid = workload[i].id;
+        processes[i].burst_time = workload[i].burst_time;
+        processes[i].arrival_time = workload[i].arrival_time;
+        processes[i].waiting_time = 0;
+    }
+
+    long decisions = policy == POLICY_RR ? round_robin(processes, n, quantum)
+                                         : srtf_scheduling(processes, n);
+
+    for (int i = 0; i < n; i++) {
+        waiting[i] = processes[i].waiting_time;
+        turnaround[i] = processes[i].waiting_time + processes[i].burst_time;
+    }
+    return decisions;
+}
+
+/* ---------------------------------------------------------------------- */
+/* Workers                                                                 */
+/* ---------------------------------------------------------------------- */
+
+static void copy_workload(Process *out, const WorkloadFile *w) {
+    for (int i = 0; i < w->count; i++) {
+        out[i].id = w->id[i];
+        out[i].burst_time = w->burst_time[i];
+        out[i].waiting_time = w->waiting_time[i];
+        out[i].system_priority = w->system_priority[i];
+        out[i].cpu_utilization = w->cpu_utilization[i];
+        out[i].memory_usage = w->memory_usage[i];
+        out[i].completed = w->completed[i] != 0;
+        out[i].arrival_time = w->arrival_time != NULL ? w->arrival_time[i] : 0;
+    }
+}
+
+static void *bench_worker(void *arg) {
+    BenchState *state = arg;
+    const BenchConfig *config = state->config;
+    int n = config->processes;
+
+    Process *workload = malloc((size_t)n * sizeof(Process));
+    struct Process *processes = malloc((size_t)n * sizeof(struct Process));
+    double *waiting = malloc((size_t)n * sizeof(double));
+    double *turnaround = malloc((size_t)n * sizeof(double));
+    if (workload == NULL || processes == NULL || waiting == NULL || turnaround == NULL) {
+        perror("Error allocating benchmark buffers");
+        exit(EXIT_FAILURE);
+    }
+
+    int first_episode = -1;
+    for (;;) {
+        int e = atomic_fetch_add(&state->next_episode, 1);
+        if (first_episode < 0) first_episode = e;
+        if (e >= config->episodes) break;
+
+        Rng rng = state->streams[e];
+        if (state->workload == NULL) {
+            generate_processes(workload, n, 0, &rng);
+        } else if (e == first_episode) {
+            copy_workload(workload, state->workload);
+        }
+        if (config->arrival_rate > 0.0) {
+            generate_arrivals(workload, n, config->arrival_rate, &rng);
+        }
+
+        for (int policy = 0; policy < POLICY_COUNT; policy++) {
+            double start = now_seconds();
+            long decisions;
+            if (policy == POLICY_Q_TABLE) {
+                decisions = run_q_table(workload, n, &rng, state->policy, waiting, turnaround);
+            } else {
+                decisions = run_baseline(policy, workload, n, config->quantum, processes, waiting, turnaround);
+            }
+
+            EpisodeResult *r = &state->results[e][policy];
+            r->wall_seconds = now_seconds() - start;
+            r->decisions = decisions;
+            summarize(waiting, n, &r->waiting_mean, &r->waiting_p50, &r->waiting_p99);
+            summarize(turnaround, n, &r->turnaround_mean, &r->turnaround_p50, &r->turnaround_p99);
+        }
+    }
+
+    free(workload);
+    free(processes);
+    free(waiting);
+    free(turnaround);
+    return NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+/* Reporting                                                               */
+/* ---------------------------------------------------------------------- */
+
+// Mean over episodes of one field, with its normal-approximation 95% CI
+static Estimate estimate(EpisodeResult (*results)[POLICY_COUNT], int episodes, int policy, size_t field) {
+    double sum = 0.0;
+    for (int e = 0; e < episodes; e++) {
+        sum += *(const double *)((const char *)&results[e][policy] + field);
+    }
+    double mean = sum / episodes;
+
+    double squares = 0.0;
+    for (int e = 0; e < episodes; e++) {
+        double d = *(const double *)((const char *)&results[e][policy] + field) - mean;
+        squares += d * d;
+    }
+    double ci = episodes > 1 ? Z_95 * sqrt(squares / (episodes - 1)) / sqrt((double)episodes) : 0.0;
+    return (Estimate){mean, ci};
+}
+
+typedef struct {
+    Estimate waiting[3];    // mean, p50, p99
+    Estimate turnaround[3];
+    Estimate wall_ms;
+    double decisions_per_second;
+    long decisions;
+} PolicySummary;
+
+static PolicySummary summarize_policy(EpisodeResult (*results)[POLICY_COUNT], int episodes, int policy) {
+    PolicySummary s;
+    s.waiting[0] = estimate(results, episodes, policy, offsetof(EpisodeResult, waiting_mean));
+    s.waiting[1] = estimate(results, episodes, policy, offsetof(EpisodeResult, waiting_p50));
+    s.waiting[2] = estimate(results, episodes, policy, offsetof(EpisodeResult, waiting_p99));
+    s.turnaround[0] = estimate(results, episodes, policy, offsetof(EpisodeResult, turnaround_mean));
+    s.turnaround[1] = estimate(results, episodes, policy, offsetof(EpisodeResult, turnaround_p50));
+    s.turnaround[2] = estimate(results, episodes, policy, offsetof(EpisodeResult, turnaround_p99));
+    s.wall_ms = estimate(results, episodes, policy, offsetof(EpisodeResult, wall_seconds));
+    s.wall_ms.mean *= 1000.0;
+    s.wall_ms.ci95 *= 1000.0;
+
+    double seconds = 0.0;
+    s.decisions = 0;
+    for (int e = 0; e < episodes; e++) {
+        seconds += results[e][policy].wall_seconds;
+        s.decisions += results[e][policy].decisions;
+    }
+    s.decisions_per_second = seconds > 0.0 ? s.decisions / seconds : 0.0;
+    return s;
+}
+
+static const char *stat_names[3] = {"mean", "p50", "p99"};
+
+// A path as a JSON string, or null
+static void write_json_path(FILE *out, const char *path) {
+    if (path == NULL) {
+        fprintf(out, "null");
+        return;
+    }
+    fputc('"', out);
+    for (const char *c = path; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') fputc('\\', out);
+        fputc(*c, out);
+    }
+    fputc('"', out);
+}
+
+static void write_json(FILE *out, const BenchConfig *config, const PolicySummary *summaries, double wall) {
+    fprintf(out, "{\n");
+    fprintf(out, "  \"config\": {\"episodes\": %d, \"processes\": %d, \"threads\": %d, "
+                 "\"quantum\": %d, \"seed\": %llu, \"arrival_rate\": %g, \"workload\": ",
+            config->episodes, config->processes, config->threads, config->quantum,
+            (unsigned long long)config->seed, config->arrival_rate);
+    write_json_path(out, config->workload_path);
+    fprintf(out, ", \"policy\": ");
+    write_json_path(out, config->policy_path);
+    fprintf(out, "},\n");
+    fprintf(out, "  \"wall_seconds\": %.6f,\n", wall);
+    fprintf(out, "  \"policies\": [\n");
+    for (int p = 0; p < POLICY_COUNT; p++) {
+        const PolicySummary *s = &summaries[p];
+        fprintf(out, "    {\n      \"name\": \"%s\",\n", policy_names[p]);
+        for (int m = 0; m < 2; m++) {
+            const Estimate *metric = m == 0 ? s->waiting : s->turnaround;
+            fprintf(out, "      \"%s\": {", m == 0 ? "waiting" : "turnaround");
+            for (int k = 0; k < 3; k++) {
+                fprintf(out, "%s\"%s\": {\"value\": %.6f, \"ci95\": %.6f}",
+                        k > 0 ? ", " : "", stat_names[k], metric[k].mean, metric[k].ci95);
+            }
+            fprintf(out, "},\n");
+        }
+        fprintf(out, "      \"decisions\": %ld,\n", s->decisions);
+        fprintf(out, "      \"decisions_per_second\": %.1f,\n", s->decisions_per_second);
+        fprintf(out, "      \"episode_wall_ms\": {\"value\": %.6f, \"ci95\": %.6f}\n",
+                s->wall_ms.mean, s->wall_ms.ci95);
+        fprintf(out, "    }%s\n", p + 1 < POLICY_COUNT ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
+
+static void write_csv(FILE *out, const PolicySummary *summaries) {
+    fprintf(out, "policy");
+    for (int m = 0; m < 2; m++) {
+        for (int k = 0; k < 3; k++) {
+            const char *metric = m == 0 ? "waiting" : "turnaround";
+            fprintf(out, ",%s_%s,%s_%s_ci95", metric, stat_names[k], metric, stat_names[k]);
+        }
+    }
+    fprintf(out, ",decisions,decisions_per_second,episode_wall_ms,episode_wall_ms_ci95\n");
+
+    for (int p = 0; p < POLICY_COUNT; p++) {
+        const PolicySummary *s = &summaries[p];
+        fprintf(out, "%s", policy_names[p]);
+        for (int k = 0; k < 3; k++) fprintf(out, ",%.6f,%.6f", s->waiting[k].mean, s->waiting[k].ci95);
+        for (int k = 0; k < 3; k++) fprintf(out, ",%.6f,%.6f", s->turnaround[k].mean, s->turnaround[k].ci95);
+        fprintf(out, ",%ld,%.1f,%.6f,%.6f\n", s->decisions, s->decisions_per_second,
+                s->wall_ms.mean, s->wall_ms.ci95);
+    }
+}
+
+static void write_file(const char *path, const BenchConfig *config, const PolicySummary *summaries,
+                       double wall, bool json) {
+    FILE *out = fopen(path, "w");
+    if (out == NULL) {
+        perror("Error opening output file");
+        exit(EXIT_FAILURE);
+    }
+    if (json) {
+        write_json(out, config, summaries, wall);
+    } else {
+        write_csv(out, summaries);
+    }
+    fclose(out);
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [--episodes N] [--processes N] [--threads N] [--quantum N] [--seed N]\n"
+            "          [--arrival-rate R] [--workload FILE] [--policy FILE] [--json FILE] [--csv FILE]\n",
+            program);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[]) {
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    BenchConfig config = {1000, 64, cores > 0 ? (int)cores : 1, TIME_QUANTUM, 1, 0.0, NULL, NULL, NULL, NULL};
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) usage(argv[0]);
+        const char *value = argv[++i];
+        if (strcmp(argv[i - 1], "--episodes") == 0) config.episodes = atoi(value);
+        else if (strcmp(argv[i - 1], "--processes") == 0) config.processes = atoi(value);
+        else if (strcmp(argv[i - 1], "--threads") == 0) config.threads = atoi(value);
+        else if (strcmp(argv[i - 1], "--quantum") == 0) config.quantum = atoi(value);
+        else if (strcmp(argv[i - 1], "--seed") == 0) config.seed = strtoull(value, NULL, 0);
+        else if (strcmp(argv[i - 1], "--arrival-rate") == 0) config.arrival_rate = atof(value);
+        else if (strcmp(argv[i - 1], "--json") == 0) config.json_path = value;
+        else if (strcmp(argv[i - 1], "--csv") == 0) config.csv_path = value;
+        else if (strcmp(argv[i - 1], "--workload") == 0) config.workload_path = value;
+        else if (strcmp(argv[i - 1], "--policy") == 0) config.policy_path = value;
+        else usage(argv[0]);
+    }
+    if (config.episodes < 1 || config.processes < 1 || config.threads < 1 || config.quantum < 1 ||
+        config.arrival_rate < 0.0) {
+        usage(argv[0]);
+    }
+
+    // Pick the kernel before the workers race to do it
+    q_kernel_level();
+
+    WorkloadFile workload;
+    if (config.workload_path != NULL) {
+        if (!workload_open(&workload, config.workload_path, true)) {
+            perror("Error opening compiled workload");
+            exit(EXIT_FAILURE);
+        }
+        if (workload.count < 1) usage(argv[0]);
+        config.processes = workload.count;
+    }
+
+    QPolicy policy;
+    if (config.policy_path != NULL && !q_policy_open(&policy, config.policy_path, true)) {
+        perror("Error opening policy");
+        exit(EXIT_FAILURE);
+    }
+
+    BenchState state;
+    state.config = &config;
+    state.workload = config.workload_path != NULL ? &workload : NULL;
+    state.policy = config.policy_path != NULL ? &policy : NULL;
+    Rng *streams = malloc((size_t)config.episodes * sizeof(Rng));
+    state.results = calloc((size_t)config.episodes, sizeof(*state.results));
+    pthread_t *threads = malloc((size_t)config.threads * sizeof(pthread_t));
+    if (streams == NULL || state.results == NULL || threads == NULL) {
+        perror("Error allocating results");
+        exit(EXIT_FAILURE);
+    }
+    Rng master;
+    rng_seed(&master, config.seed);
+    for (int e = 0; e < config.episodes; e++) {
+        streams[e] = master;
+        rng_jump(&master);
+    }
+    state.streams = streams;
+    atomic_init(&state.next_episode, 0);
+
+    double start = now_seconds();
+    for (int t = 0; t < config.threads; t++) {
+        if (pthread_create(&threads[t], NULL, bench_worker, &state) != 0) {
+            perror("Error starting benchmark thread");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int t = 0; t < config.threads; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    double wall = now_seconds() - start;
+
+    PolicySummary summaries[POLICY_COUNT];
+    for (int p = 0; p < POLICY_COUNT; p++) {
+        summaries[p] = summarize_policy(state.results, config.episodes, p);
+    }
+
+    printf("%d episodes x %d processes, %d threads, quantum %d, seed %llu", config.episodes,
+           config.processes, config.threads, config.quantum, (unsigned long long)config.seed);
+    if (config.arrival_rate > 0.0) printf(", arrival rate %g", config.arrival_rate);
+    if (config.policy_path != NULL) printf(", policy %s", config.policy_path);
+    printf(": %.3f s\n\n", wall);
+    printf("%-12s %22s %22s %22s %14s %12s\n", "Policy", "Waiting mean", "Waiting p99",
+           "Turnaround mean", "Decisions/s", "ms/episode");
+    for (int p = 0; p < POLICY_COUNT; p++) {
+        const PolicySummary *s = &summaries[p];
+        printf("%-12s %12.2f +/- %5.2f %12.2f +/- %5.2f %12.2f +/- %5.2f %14.0f %12.4f\n",
+               policy_names[p], s->waiting[0].mean, s->waiting[0].ci95, s->waiting[2].mean,
+               s->waiting[2].ci95, s->turnaround[0].mean, s->turnaround[0].ci95,
+               s->decisions_per_second, s->wall_ms.mean);
+    }
+
+    if (config.json_path != NULL) write_file(config.json_path, &config, summaries, wall, true);
+    if (config.csv_path != NULL) write_file(config.csv_path, &config, summaries, wall, false);
+
+    free(threads);
+    free(streams);
+    if (config.workload_path != NULL) workload_close(&workload);
+    if (config.policy_path != NULL) q_policy_free(&policy);
+    free(state.results);
+    return 0;
+}
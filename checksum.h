@@ -0,0 +1,41 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Checksum of the binary file formats (compiled workloads, Q policy
+// snapshots)
+
+static inline uint64_t checksum_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+// Four independent multiply-rotate lanes, so the checksum runs near
+// memory speed; not cryptographic, it only has to catch corruption
+static inline uint64_t file_checksum(const void *data, size_t size) {
+    const uint64_t p1 = 0x9e3779b185ebca87ull, p2 = 0xc2b2ae3d27d4eb4full;
+    const unsigned char *bytes = (const unsigned char *)data;
+    uint64_t lanes[4] = {p1, p2, ~p1, ~p2};
+    size_t i = 0;
+
+    for (; i + 32 <= size; i += 32) {
+        for (int l = 0; l < 4; l++) {
+            uint64_t word;
+            memcpy(&word, bytes + i + 8 * l, 8);
+            lanes[l] = checksum_rotl(lanes[l] + word * p2, 31) * p1;
+        }
+    }
+    uint64_t h = checksum_rotl(lanes[0], 1) + checksum_rotl(lanes[1], 7) + checksum_rotl(lanes[2], 12) + checksum_rotl(lanes[3], 18);
+    for (; i < size; i++) {
+        h = (h ^ bytes[i]) * p1;
+    }
+    h ^= size;
+    h ^= h >> 33;
+    h *= p2;
+    h ^= h >> 29;
+    return h;
+}
+
+#endif // CHECKSUM_H
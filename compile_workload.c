@@ -0,0 +1,35 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include "process_store.h"
+#include "workload.h"
+
+// Convert a CSV workload into the compiled column format, which the
+// simulators and the benchmark map directly instead of parsing.
+int main(int argc, char* argv[]) {
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <workload.csv> <workload.qwl>\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    ProcessStore store;
+    if (!store_init(&store, 0)) {
+        perror("Error allocating process store");
+        exit(EXIT_FAILURE);
+    }
+
+    WorkloadStats stats;
+    if (!workload_load(&store, argv[1], 0, &stats)) {
+        if (stats.bad_lines == 0) {
+            perror("Error reading input file");
+        }
+        exit(EXIT_FAILURE);
+    }
+    if (!workload_write_compiled(&store, argv[2])) {
+        perror("Error writing compiled workload");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("Compiled %d processes from %s into %s\n", store.count, argv[1], argv[2]);
+    store_free(&store);
+    return 0;
+}
@@ -0,0 +1,398 @@
+#include "dqn.h"
+
+#include <cerrno>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "checksum.h"
+#include "rng.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DQN_X86 1
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+static_assert(sizeof(DqnFileHeader) == 72, "header has no padding");
+
+static const char dqnMagic[8] = "QDQN";
+static const char* kernelNames[] = {"scalar", "avx2"};
+
+constexpr int DqnMaxWidth = 1 << 16;
+
+/* ---------------------------------------------------------------------- */
+/* Kernels: y = x W^T + b for a batch, ReLU optionally                    */
+/* ---------------------------------------------------------------------- */
+
+// The reference: weights as PyTorch holds them. Input i goes into partial
+// sum i % DqnPartials, so the additions form independent chains, and the
+// partial sums are added pairwise before the bias.
+constexpr int DqnPartials = 4;
+
+static void layerScalar(const float* weights, const float* bias, int in, int out, int padded, const float* x,
+                        int xStride, int batch, float* y, bool relu) {
+    for (int b = 0; b < batch; b++) {
+        const float* row = x + (std::size_t)b * xStride;
+        float* result = y + (std::size_t)b * padded;
+        for (int o = 0; o < out; o++) {
+            const float* w = weights + (std::size_t)o * in;
+            float partial[DqnPartials] = {0.0f, 0.0f, 0.0f, 0.0f};
+            int i = 0;
+            for (; i + DqnPartials <= in; i += DqnPartials) {
+                for (int p = 0; p < DqnPartials; p++) partial[p] = partial[p] + w[i + p] * row[i + p];
+            }
+            for (int p = 0; i < in; i++, p++) partial[p] = partial[p] + w[i] * row[i];
+            float acc = ((partial[0] + partial[1]) + (partial[2] + partial[3])) + bias[o];
+            result[o] = relu ? (acc > 0.0f ? acc : 0.0f) : acc;
+        }
+        for (int o = out; o < padded; o++) result[o] = 0.0f;
+    }
+}
+
+#ifdef DQN_X86
+
+// U blocks of 8 outputs of one input row, with the partial sums of each
+// kept in registers across the inputs
+template <int U>
+AVX2_TARGET static inline void outputBlockAvx2(const float* packed, const float* bias, int in, int padded,
+                                               const float* row, float* result, bool relu) {
+    __m256 acc[U][DqnPartials];
+    for (int u = 0; u < U; u++) {
+        for (int p = 0; p < DqnPartials; p++) acc[u][p] = _mm256_setzero_ps();
+    }
+    int i = 0;
+    for (; i + DqnPartials <= in; i += DqnPartials) {
+        for (int p = 0; p < DqnPartials; p++) {
+            __m256 xi = _mm256_set1_ps(row[i + p]);
+            const float* w = packed + (std::size_t)(i + p) * padded;
+            for (int u = 0; u < U; u++) {
+                acc[u][p] = _mm256_add_ps(acc[u][p], _mm256_mul_ps(_mm256_loadu_ps(w + 8 * u), xi));
+            }
+        }
+    }
+    for (int p = 0; i < in; i++, p++) {
+        __m256 xi = _mm256_set1_ps(row[i]);
+        const float* w = packed + (std::size_t)i * padded;
+        for (int u = 0; u < U; u++) {
+            acc[u][p] = _mm256_add_ps(acc[u][p], _mm256_mul_ps(_mm256_loadu_ps(w + 8 * u), xi));
+        }
+    }
+    for (int u = 0; u < U; u++) {
+        __m256 sum = _mm256_add_ps(_mm256_add_ps(acc[u][0], acc[u][1]), _mm256_add_ps(acc[u][2], acc[u][3]));
+        sum = _mm256_add_ps(sum, _mm256_loadu_ps(bias + 8 * u));
+        if (relu) sum = _mm256_max_ps(sum, _mm256_setzero_ps());
+        _mm256_storeu_ps(result + 8 * u, sum);
+    }
+}
+
+AVX2_TARGET static void layerAvx2(const float* packed, const float* bias, int in, int padded, const float* x,
+                                  int xStride, int batch, float* y, bool relu) {
+    for (int b = 0; b < batch; b++) {
+        const float* row = x + (std::size_t)b * xStride;
+        float* result = y + (std::size_t)b * padded;
+        int o = 0;
+        for (; o + 16 <= padded; o += 16) {
+            outputBlockAvx2<2>(packed + o, bias + o, in, padded, row, result + o, relu);
+        }
+        if (o < padded) outputBlockAvx2<1>(packed + o, bias + o, in, padded, row, result + o, relu);
+    }
+}
+
+#endif
+
+/* ---------------------------------------------------------------------- */
+/* Dispatch                                                               */
+/* ---------------------------------------------------------------------- */
+
+static int activeKernel = -1;
+static double checkTolerance = -1; // negative: check mode off
+
+const char* dqnKernelName(DqnKernel kernel) {
+    return kernelNames[(int)kernel];
+}
+
+DqnKernel dqnKernel() {
+    if (activeKernel >= 0) return (DqnKernel)activeKernel;
+
+    int kernel = (int)DqnKernel::Scalar;
+#ifdef DQN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) kernel = (int)DqnKernel::Avx2;
+#endif
+
+    const char* forced = std::getenv("DQN_KERNEL");
+    if (forced != nullptr) {
+        int requested = -1;
+        for (int k = 0; k <= (int)DqnKernel::Avx2; k++) {
+            if (std::strcmp(forced, kernelNames[k]) == 0) requested = k;
+        }
+        if (requested < 0) {
+            std::fprintf(stderr, "Unknown DQN_KERNEL '%s', using %s\n", forced, kernelNames[kernel]);
+        } else if (requested > kernel) {
+            std::fprintf(stderr, "DQN_KERNEL %s is not supported by this CPU, using %s\n", forced,
+                         kernelNames[kernel]);
+        } else {
+            kernel = requested;
+        }
+    }
+
+    const char* check = std::getenv("DQN_KERNEL_CHECK");
+    if (check != nullptr) {
+        checkTolerance = std::fabs(std::atof(check));
+    }
+
+    activeKernel = kernel;
+    return (DqnKernel)kernel;
+}
+
+/* ---------------------------------------------------------------------- */
+/* Model                                                                  */
+/* ---------------------------------------------------------------------- */
+
+bool DqnModel::build(const std::vector<int>& widths) {
+    if (widths.size() < 2 || widths.size() > DqnMaxLayers + 1) return false;
+    for (int width : widths) {
+        if (width < 1 || width > DqnMaxWidth) return false;
+    }
+    dims = widths;
+    layers.assign(widths.size() - 1, Layer{});
+    for (std::size_t l = 0; l < layers.size(); l++) {
+        Layer& layer = layers[l];
+        layer.in = widths[l];
+        layer.out = widths[l + 1];
+        layer.padded = (layer.out + 7) & ~7;
+        layer.weights.assign((std::size_t)layer.out * layer.in, 0.0f);
+        layer.bias.assign((std::size_t)layer.out, 0.0f);
+    }
+    return true;
+}
+
+void DqnModel::pack() {
+    for (Layer& layer : layers) {
+        layer.packed.assign((std::size_t)layer.in * layer.padded, 0.0f);
+        layer.packedBias.assign((std::size_t)layer.padded, 0.0f);
+        for (int o = 0; o < layer.out; o++) {
+            for (int i = 0; i < layer.in; i++) {
+                layer.packed[(std::size_t)i * layer.padded + o] = layer.weights[(std::size_t)o * layer.in + i];
+            }
+            layer.packedBias[o] = layer.bias[o];
+        }
+    }
+}
+
+static std::size_t weightsSize(const std::vector<int>& dims) {
+    std::size_t floats = 0;
+    for (std::size_t l = 0; l + 1 < dims.size(); l++) {
+        floats += (std::size_t)dims[l + 1] * dims[l] + dims[l + 1];
+    }
+    return floats * sizeof(float);
+}
+
+bool DqnModel::load(const char* path) {
+    FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) return false;
+    DqnFileHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1) {
+        std::fclose(file);
+        errno = EINVAL;
+        return false;
+    }
+
+    std::vector<int> widths;
+    bool valid = std::memcmp(header.magic, dqnMagic, sizeof(header.magic)) == 0 && header.version == DqnVersion &&
+                 header.layers >= 1 && header.layers <= DqnMaxLayers;
+    for (uint32_t d = 0; valid && d <= DqnMaxLayers; d++) {
+        if (d <= header.layers) {
+            valid = header.dims[d] >= 1 && header.dims[d] <= DqnMaxWidth;
+            widths.push_back((int)header.dims[d]);
+        } else {
+            valid = header.dims[d] == 0;
+        }
+    }
+    valid = valid && header.weights_size == weightsSize(widths);
+    if (!valid) {
+        std::fclose(file);
+        errno = EINVAL;
+        return false;
+    }
+    if (header.header_checksum != file_checksum(&header, offsetof(DqnFileHeader, header_checksum))) {
+        std::fclose(file);
+        errno = EBADMSG;
+        return false;
+    }
+
+    std::vector<float> data(header.weights_size / sizeof(float));
+    bool complete = std::fread(data.data(), 1, header.weights_size, file) == header.weights_size;
+    std::fclose(file);
+    if (!complete) {
+        errno = EINVAL;
+        return false;
+    }
+    if (header.weights_checksum != file_checksum(data.data(), header.weights_size)) {
+        errno = EBADMSG;
+        return false;
+    }
+
+    return setParameters(widths, data);
+}
+
+bool DqnModel::setParameters(const std::vector<int>& widths, const std::vector<float>& params) {
+    if (!build(widths) || params.size() * sizeof(float) != weightsSize(widths)) {
+        dims.clear();
+        layers.clear();
+        errno = EINVAL;
+        return false;
+    }
+    const float* next = params.data();
+    for (Layer& layer : layers) {
+        std::memcpy(layer.weights.data(), next, layer.weights.size() * sizeof(float));
+        next += layer.weights.size();
+        std::memcpy(layer.bias.data(), next, layer.bias.size() * sizeof(float));
+        next += layer.bias.size();
+    }
+    pack();
+    return true;
+}
+
+std::vector<float> DqnModel::parameters() const {
+    std::vector<float> params;
+    for (const Layer& layer : layers) {
+        params.insert(params.end(), layer.weights.begin(), layer.weights.end());
+        params.insert(params.end(), layer.bias.begin(), layer.bias.end());
+    }
+    return params;
+}
+
+bool DqnModel::save(const char* path) const {
+    DqnFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, dqnMagic, sizeof(header.magic));
+    header.version = DqnVersion;
+    header.layers = (uint32_t)layers.size();
+    for (std::size_t d = 0; d < dims.size(); d++) header.dims[d] = (uint32_t)dims[d];
+
+    std::vector<float> data = parameters();
+    header.weights_size = data.size() * sizeof(float);
+    header.weights_checksum = file_checksum(data.data(), header.weights_size);
+    header.header_checksum = file_checksum(&header, offsetof(DqnFileHeader, header_checksum));
+
+    FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) return false;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(data.data(), 1, header.weights_size, file) == header.weights_size;
+    if (std::fclose(file) != 0) ok = false;
+    return ok;
+}
+
+void DqnModel::initRandom(const std::vector<int>& widths, uint64_t seed) {
+    if (!build(widths)) {
+        dims.clear();
+        layers.clear();
+        return;
+    }
+    Rng rng;
+    rng_seed(&rng, seed);
+    for (Layer& layer : layers) {
+        double bound = 1.0 / std::sqrt((double)layer.in);
+        for (float& w : layer.weights) w = (float)((2.0 * rng_double(&rng) - 1.0) * bound);
+        for (float& b : layer.bias) b = (float)((2.0 * rng_double(&rng) - 1.0) * bound);
+    }
+    pack();
+}
+
+void DqnModel::forward(const float* x, int batch, float* q) const {
+    DqnKernel kernel = dqnKernel();
+    forward(x, batch, q, kernel);
+
+    if (checkTolerance >= 0 && kernel != DqnKernel::Scalar) {
+        std::vector<float> expected((std::size_t)batch * actions());
+        forward(x, batch, expected.data(), DqnKernel::Scalar);
+        for (std::size_t k = 0; k < expected.size(); k++) {
+            bool mismatch = checkTolerance == 0
+                                ? std::memcmp(&expected[k], &q[k], sizeof(float)) != 0
+                                : !(std::fabs((double)expected[k] - (double)q[k]) <= checkTolerance);
+            if (mismatch) {
+                std::fprintf(stderr, "DQN kernel check failed: Q value %zu is %.9g with %s, %.9g with scalar\n", k,
+                             q[k], kernelNames[(int)kernel], expected[k]);
+                std::exit(EXIT_FAILURE);
+            }
+        }
+    }
+}
+
+void DqnModel::forward(const float* x, int batch, float* q, DqnKernel kernel) const {
+    const float* input = x;
+    int stride = inputs();
+    for (std::size_t l = 0; l < layers.size(); l++) {
+        const Layer& layer = layers[l];
+        std::vector<float>& output = activations[l % 2];
+        if (output.size() < (std::size_t)batch * layer.padded) output.resize((std::size_t)batch * layer.padded);
+        bool relu = l + 1 < layers.size();
+#ifdef DQN_X86
+        if (kernel == DqnKernel::Avx2) {
+            layerAvx2(layer.packed.data(), layer.packedBias.data(), layer.in, layer.padded, input, stride, batch,
+                      output.data(), relu);
+        } else
+#endif
+        {
+            layerScalar(layer.weights.data(), layer.bias.data(), layer.in, layer.out, layer.padded, input, stride,
+                        batch, output.data(), relu);
+        }
+        input = output.data();
+        stride = layer.padded;
+    }
+
+    int n = actions();
+    for (int b = 0; b < batch; b++) {
+        std::memcpy(q + (std::size_t)b * n, input + (std::size_t)b * stride, (std::size_t)n * sizeof(float));
+    }
+}
+
+/* ---------------------------------------------------------------------- */
+/* Policy                                                                 */
+/* ---------------------------------------------------------------------- */
+
+DqnPolicy::DqnPolicy(const DqnModel& model) : model(model) {}
+
+int DqnPolicy::select(const ProcessStore* store) {
+    int n = store->active_count;
+    if (n == 0) return -1;
+    int window = model.actions();
+    int windows = (n + window - 1) / window;
+    states.assign((std::size_t)windows * Features, 0.0f);
+    q.resize((std::size_t)windows * window);
+    if (ran.size() < (std::size_t)store->count) ran.resize((std::size_t)store->count, 0);
+
+    // Window w holds active processes w * window .. (w + 1) * window - 1,
+    // so process k's Q value is q[k]
+    for (int k = 0; k < n; k++) {
+        int slot = store->active[k];
+        float* state = &states[(std::size_t)(k / window) * Features];
+        state[0] += (float)store->system_priority[slot] / 10.0f;
+        state[1] += (float)store->burst_time[slot] / 20.0f;
+        state[2] += (float)store_waiting_time(store, slot) / 50.0f;
+        state[3] += store->cpu_utilization[slot] < 0.5f ? 1.0f : 0.0f;
+        state[4] += store->memory_usage[slot];
+        state[5] += ran[slot] ? 1.0f : 0.0f;
+    }
+    for (int w = 0; w < windows; w++) {
+        int members = w + 1 < windows ? window : n - w * window;
+        for (int f = 0; f < Features; f++) states[(std::size_t)w * Features + f] /= (float)members;
+    }
+    model.forward(states.data(), windows, q.data());
+
+    int best = 0;
+    for (int k = 1; k < n; k++) {
+        if (q[k] > q[best]) best = k;
+    }
+    int slot = store->active[best];
+    ran[slot] = 1;
+    return slot;
+}
+
+int DqnPolicy::selector(const ProcessStore* store, void* policy) {
+    return static_cast<DqnPolicy*>(policy)->select(store);
+}
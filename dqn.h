@@ -0,0 +1,120 @@
+#ifndef DQN_H
+#define DQN_H
+
+#include <cstdint>
+#include <vector>
+
+#include "process_store.h"
+
+// Inference for the DQN of Deep_Q_RL_based_Simulator.py, without Python.
+//
+// The network is an MLP, ReLU after every layer but the last (6 -> 64 ->
+// 64 -> N as trained). export_weights() in the Python file writes it as:
+//   DqnFileHeader
+//   for each layer: weights, out x in, row-major as PyTorch holds them,
+//                   then the out biases
+// all little-endian float32, with checksums of the header and the weights.
+//
+// DqnModel keeps every layer transposed and padded to a multiple of 8
+// outputs, so a forward pass runs 8 outputs per instruction with AVX2 and
+// a batch of inputs goes through each layer while its weights are in
+// cache. The AVX2 path does the multiplies and adds in the scalar path's
+// order, without fusing them, so both produce the same bits. The best
+// kernel the CPU supports is picked at first use; DQN_KERNEL=scalar|avx2
+// forces one and DQN_KERNEL_CHECK=<tolerance> checks every forward pass
+// against the scalar path, as Q_KERNEL and Q_KERNEL_CHECK do (q_kernel.h).
+
+constexpr int DqnMaxLayers = 7;
+constexpr uint32_t DqnVersion = 1;
+
+struct DqnFileHeader {
+    char magic[8];                     // "QDQN\0\0\0\0"
+    uint32_t version;
+    uint32_t layers;
+    uint32_t dims[DqnMaxLayers + 1];   // inputs, hidden widths, actions; 0 after the last
+    uint64_t weights_size;             // bytes after the header
+    uint64_t weights_checksum;
+    uint64_t header_checksum;          // of the bytes before it
+};
+
+enum class DqnKernel { Scalar, Avx2 };
+
+DqnKernel dqnKernel();
+const char* dqnKernelName(DqnKernel kernel);
+
+class DqnModel {
+public:
+    // Returns false with errno set (EINVAL for a file that is not a model of
+    // this version, EBADMSG for a checksum mismatch)
+    bool load(const char* path);
+    bool save(const char* path) const;
+
+    // PyTorch's default initialization of nn.Linear, from a seed: a model
+    // to run without a trained file
+    void initRandom(const std::vector<int>& dims, uint64_t seed);
+
+    // The weights and biases in the file's order, and a model from them
+    std::vector<float> parameters() const;
+    bool setParameters(const std::vector<int>& dims, const std::vector<float>& params);
+
+    const std::vector<int>& widths() const { return dims; }
+    int inputs() const { return dims.empty() ? 0 : dims.front(); }
+    int actions() const { return dims.empty() ? 0 : dims.back(); }
+
+    // q[b * actions() + a] for the inputs x[b * inputs() + i], b < batch.
+    // Uses buffers of the model: one pass at a time per model.
+    void forward(const float* x, int batch, float* q) const;
+    void forward(const float* x, int batch, float* q, DqnKernel kernel) const;
+
+private:
+    struct Layer {
+        int in;
+        int out;
+        int padded;                 // out rounded up to 8
+        std::vector<float> weights; // out x in, as in the file
+        std::vector<float> bias;    // out
+        std::vector<float> packed;  // in x padded, transposed
+        std::vector<float> packedBias; // padded
+    };
+
+    bool build(const std::vector<int>& dims);
+    void pack();
+
+    std::vector<int> dims;
+    std::vector<Layer> layers;
+    mutable std::vector<float> activations[2];
+};
+
+// The DQN as a scheduling policy for SimEngine (sim_set_selector()).
+//
+// The Python model scores N processes at once from their mean state, one
+// action per process. The policy splits the store's active processes into
+// windows of N in active-list order, builds each window's mean state the
+// way CPUEnvironment.get_state() does, scores every window in one batched
+// forward pass, and runs the process with the highest Q value. With N
+// processes that is the Python agent's greedy choice; the actions of a
+// window's missing processes are never taken.
+//
+// Process features map onto the Python state as
+//   priority / 10, burst / 20, waiting / 50,
+//   I/O bound: CPU usage under a half,
+//   memory usage (already a fraction),
+//   in CPU: the process has run before.
+class DqnPolicy {
+public:
+    static constexpr int Features = 6;
+
+    // The model has to take Features inputs
+    explicit DqnPolicy(const DqnModel& model);
+
+    int select(const ProcessStore* store);
+    static int selector(const ProcessStore* store, void* policy);
+
+private:
+    const DqnModel& model;
+    std::vector<float> states;
+    std::vector<float> q;
+    std::vector<unsigned char> ran; // [slot]
+};
+
+#endif // DQN_H
@@ -0,0 +1,214 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "dqn.h"
+#include "q_scheduler.h"
+#include "sim_engine.h"
+
+// The DQN policy without Python: loads a model exported by
+// Deep_Q_RL_based_Simulator.py, or makes a seeded random one of the same
+// shape, and reports
+//   latency  nanoseconds per batched forward pass with the scalar and the
+//            AVX2 kernel, and per decision of the policy, for each number
+//            of ready processes; both kernels must give the same bits
+//   episodes seeded workloads run to completion through SimEngine with the
+//            DQN as the policy and with the Q-table, mean waiting time and
+//            decisions per second of each
+
+constexpr int MaxSizes = 8;
+
+struct DqnBenchConfig {
+    const char* modelPath = nullptr;
+    const char* initPath = nullptr; // write the random model here
+    int sizes[MaxSizes] = {5, 64, 1024};
+    int sizeCount = 3;
+    long decisions = 100000;        // per size, scaled down for large sizes
+    int episodes = 10;
+    int processes = 64;
+    uint64_t seed = 1;
+};
+
+static double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static std::vector<Process> workloadFor(int n, uint64_t seed) {
+    std::vector<Process> workload((std::size_t)n);
+    Rng rng;
+    rng_seed(&rng, seed);
+    generate_processes(workload.data(), n, 0, &rng);
+    return workload;
+}
+
+static bool runLatency(const DqnBenchConfig& config, const DqnModel& model, int n) {
+    ProcessStore store;
+    if (!store_init(&store, n)) {
+        std::perror("Error allocating store");
+        std::exit(EXIT_FAILURE);
+    }
+    for (const Process& p : workloadFor(n, config.seed)) store_add(&store, p);
+
+    long decisions = config.decisions * 64 / (n > 64 ? n : 64);
+    if (decisions < 100) decisions = 100;
+
+    DqnPolicy policy(model);
+    int windows = (n + model.actions() - 1) / model.actions();
+    std::vector<float> states((std::size_t)windows * DqnPolicy::Features);
+    for (std::size_t k = 0; k < states.size(); k++) states[k] = (float)(k % 7) / 7.0f;
+    std::vector<float> scalar((std::size_t)windows * model.actions());
+    std::vector<float> vector(scalar.size());
+
+    // The vector column is the best kernel available, scalar without AVX2
+    double seconds[2];
+    std::vector<float>* outputs[2] = {&scalar, &vector};
+    DqnKernel kernels[2] = {DqnKernel::Scalar, dqnKernel()};
+    for (int k = 0; k < 2; k++) {
+        DqnKernel kernel = kernels[k];
+        double start = nowSeconds();
+        for (long d = 0; d < decisions; d++) {
+            model.forward(states.data(), windows, outputs[k]->data(), kernel);
+        }
+        seconds[k] = nowSeconds() - start;
+    }
+    bool same = std::memcmp(scalar.data(), vector.data(), scalar.size() * sizeof(float)) == 0;
+
+    double start = nowSeconds();
+    for (long d = 0; d < decisions; d++) {
+        policy.select(&store);
+    }
+    double decide = nowSeconds() - start;
+
+    std::printf("%10d %8d %12.0f %12.0f %14.0f   %s\n", n, windows, seconds[0] * 1e9 / decisions,
+                seconds[1] * 1e9 / decisions, decide * 1e9 / decisions, same ? "yes" : "NO");
+    store_free(&store);
+    return same;
+}
+
+struct EpisodeResult {
+    double waiting = 0.0;
+    long decisions = 0;
+    double seconds = 0.0;
+};
+
+static EpisodeResult runEpisode(const std::vector<Process>& workload, uint64_t seed, DqnPolicy* policy) {
+    SimEngine sim;
+    if (!sim_init(&sim, (int)workload.size())) {
+        std::perror("Error allocating simulation");
+        std::exit(EXIT_FAILURE);
+    }
+    for (const Process& p : workload) sim_add_process(&sim, p);
+    sim_seed(&sim, seed);
+    if (policy != nullptr) sim_set_selector(&sim, DqnPolicy::selector, policy);
+
+    EpisodeResult result;
+    double start = nowSeconds();
+    while (sim_step(&sim)) result.decisions++;
+    result.seconds = nowSeconds() - start;
+    for (int i = 0; i < sim.store.count; i++) result.waiting += store_waiting_time(&sim.store, i);
+    result.waiting /= sim.store.count > 0 ? sim.store.count : 1;
+    sim_free(&sim);
+    return result;
+}
+
+static void runEpisodes(const DqnBenchConfig& config, const DqnModel& model) {
+    EpisodeResult totals[2];
+    for (int e = 0; e < config.episodes; e++) {
+        std::vector<Process> workload = workloadFor(config.processes, config.seed + (uint64_t)e);
+        DqnPolicy policy(model);
+        EpisodeResult dqn = runEpisode(workload, config.seed + (uint64_t)e, &policy);
+        EpisodeResult qTable = runEpisode(workload, config.seed + (uint64_t)e, nullptr);
+        EpisodeResult* results[2] = {&dqn, &qTable};
+        for (int k = 0; k < 2; k++) {
+            totals[k].waiting += results[k]->waiting;
+            totals[k].decisions += results[k]->decisions;
+            totals[k].seconds += results[k]->seconds;
+        }
+    }
+
+    std::printf("\n%d episodes x %d processes\n", config.episodes, config.processes);
+    std::printf("%-8s %14s %14s\n", "Policy", "Mean waiting", "Decisions/s");
+    const char* names[2] = {"dqn", "q_table"};
+    for (int k = 0; k < 2; k++) {
+        std::printf("%-8s %14.2f %14.0f\n", names[k], totals[k].waiting / config.episodes,
+                    totals[k].seconds > 0.0 ? totals[k].decisions / totals[k].seconds : 0.0);
+    }
+}
+
+static void usage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [--model FILE | --init-model FILE] [--sizes N[,N...]] [--decisions N]\n"
+                 "          [--episodes N] [--processes N] [--seed N]\n",
+                 program);
+    std::exit(EXIT_FAILURE);
+}
+
+static void parseSizes(DqnBenchConfig& config, char* list, const char* program) {
+    config.sizeCount = 0;
+    for (char* item = std::strtok(list, ","); item != nullptr; item = std::strtok(nullptr, ",")) {
+        if (config.sizeCount == MaxSizes) usage(program);
+        config.sizes[config.sizeCount++] = std::atoi(item);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    DqnBenchConfig config;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) usage(argv[0]);
+        char* value = argv[++i];
+        if (std::strcmp(argv[i - 1], "--model") == 0) config.modelPath = value;
+        else if (std::strcmp(argv[i - 1], "--init-model") == 0) config.initPath = value;
+        else if (std::strcmp(argv[i - 1], "--sizes") == 0) parseSizes(config, value, argv[0]);
+        else if (std::strcmp(argv[i - 1], "--decisions") == 0) config.decisions = std::atol(value);
+        else if (std::strcmp(argv[i - 1], "--episodes") == 0) config.episodes = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--processes") == 0) config.processes = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--seed") == 0) config.seed = std::strtoull(value, nullptr, 0);
+        else usage(argv[0]);
+    }
+    if (config.sizeCount < 1 || config.decisions < 1 || config.episodes < 0 || config.processes < 1 ||
+        (config.modelPath != nullptr && config.initPath != nullptr)) {
+        usage(argv[0]);
+    }
+    for (int s = 0; s < config.sizeCount; s++) {
+        if (config.sizes[s] < 1) usage(argv[0]);
+    }
+
+    DqnModel model;
+    if (config.modelPath != nullptr) {
+        if (!model.load(config.modelPath)) {
+            std::perror("Error loading model");
+            std::exit(EXIT_FAILURE);
+        }
+    } else {
+        // The shape Deep_Q_RL_based_Simulator.py trains
+        model.initRandom({DqnPolicy::Features, 64, 64, 5}, config.seed);
+        if (config.initPath != nullptr && !model.save(config.initPath)) {
+            std::perror("Error writing model");
+            std::exit(EXIT_FAILURE);
+        }
+    }
+    if (model.inputs() != DqnPolicy::Features) {
+        std::fprintf(stderr, "The model takes %d inputs, the policy gives %d\n", model.inputs(),
+                     DqnPolicy::Features);
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::printf("Model %s: %d inputs, %d actions, kernel %s\n",
+                config.modelPath != nullptr ? config.modelPath : "random", model.inputs(), model.actions(),
+                dqnKernelName(dqnKernel()));
+    std::printf("%10s %8s %12s %12s %14s   %s\n", "Processes", "Windows", "Scalar ns", "Vector ns",
+                "Decision ns", "Same bits");
+    bool ok = true;
+    for (int s = 0; s < config.sizeCount; s++) {
+        ok = runLatency(config, model, config.sizes[s]) && ok;
+    }
+    if (config.episodes > 0) runEpisodes(config, model);
+    if (!ok) {
+        std::fprintf(stderr, "The AVX2 kernel did not reproduce the scalar one\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
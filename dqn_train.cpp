@@ -0,0 +1,596 @@
+#include "dqn_train.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <system_error>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define DQN_X86 1
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+/* ---------------------------------------------------------------------- */
+/* Replay memory                                                          */
+/* ---------------------------------------------------------------------- */
+
+ReplayRing::ReplayRing(int capacity, int stateSize)
+    : capacity(capacity),
+      stateSize(stateSize),
+      states((std::size_t)capacity * stateSize),
+      nextStates((std::size_t)capacity * stateSize),
+      actions((std::size_t)capacity),
+      rewards((std::size_t)capacity),
+      dones((std::size_t)capacity) {}
+
+void ReplayRing::push(const float* state, int action, float reward, const float* nextState, bool done) {
+    std::memcpy(&states[(std::size_t)head * stateSize], state, (std::size_t)stateSize * sizeof(float));
+    std::memcpy(&nextStates[(std::size_t)head * stateSize], nextState, (std::size_t)stateSize * sizeof(float));
+    actions[head] = action;
+    rewards[head] = reward;
+    dones[head] = done;
+    head = head + 1 == capacity ? 0 : head + 1;
+    if (count < capacity) count++;
+}
+
+// Floyd's algorithm: n draws, no rejection loop
+void ReplayRing::sample(Rng* rng, int n, int* out) const {
+    for (int k = 0, j = count - n; k < n; k++, j++) {
+        int pick = (int)rng_below(rng, (uint32_t)j + 1);
+        for (int m = 0; m < k; m++) {
+            if (out[m] == pick) {
+                pick = j;
+                break;
+            }
+        }
+        out[k] = pick;
+    }
+}
+
+/* ---------------------------------------------------------------------- */
+/* Environment                                                            */
+/* ---------------------------------------------------------------------- */
+
+DqnEnv::DqnEnv(int processes, uint64_t seed) : procs((std::size_t)processes) {
+    rng_seed(&rng, seed);
+    reset();
+}
+
+void DqnEnv::reset() {
+    for (Proc& p : procs) {
+        p.priority = 1 + (int)rng_below(&rng, 10);
+        p.burst = 1 + (int)rng_below(&rng, 20);
+        p.waiting = 0;
+        p.ioBound = (int)rng_below(&rng, 2);
+        p.memory = 1 + (int)rng_below(&rng, 100);
+        p.inCpu = 0;
+    }
+}
+
+void DqnEnv::state(float* out) const {
+    double sum[Features] = {0, 0, 0, 0, 0, 0};
+    for (const Proc& p : procs) {
+        sum[0] += p.priority / 10.0;
+        sum[1] += p.burst / 20.0;
+        sum[2] += p.waiting / 50.0;
+        sum[3] += p.ioBound;
+        sum[4] += p.memory / 100.0;
+        sum[5] += p.inCpu;
+    }
+    for (int f = 0; f < Features; f++) out[f] = (float)(sum[f] / (double)procs.size());
+}
+
+bool DqnEnv::step(int action, float* reward) {
+    Proc& run = procs[(std::size_t)action];
+    run.inCpu = 1;
+    for (Proc& p : procs) {
+        if (&p != &run) p.waiting++;
+    }
+    run.burst = std::max(0, run.burst - 1);
+    *reward = (float)(-0.1 * run.waiting + (run.burst == 0 ? 1.0 : 0.0));
+
+    for (const Proc& p : procs) {
+        if (p.burst != 0) return false;
+    }
+    return true;
+}
+
+double DqnEnv::meanWaiting() const {
+    double sum = 0;
+    for (const Proc& p : procs) sum += p.waiting;
+    return sum / (double)procs.size();
+}
+
+/* ---------------------------------------------------------------------- */
+/* Kernels, over widths padded to multiples of 8                          */
+/* ---------------------------------------------------------------------- */
+
+namespace {
+
+// The reference order of every sum; the AVX2 kernels keep it
+struct ScalarKernels {
+    // y = x W^T + b for each row, from W transposed (in x out)
+    static void forward(const float* wt, const float* bias, int in, int out, const float* x, float* y, int rows,
+                        std::size_t stride, bool relu) {
+        for (int r = 0; r < rows; r++) {
+            const float* xr = x + (std::size_t)r * stride;
+            float* yr = y + (std::size_t)r * stride;
+            for (int o = 0; o < out; o++) yr[o] = bias[o];
+            for (int i = 0; i < in; i++) {
+                for (int o = 0; o < out; o++) yr[o] = yr[o] + xr[i] * wt[(std::size_t)i * out + o];
+            }
+            if (relu) {
+                for (int o = 0; o < out; o++) yr[o] = yr[o] > 0.0f ? yr[o] : 0.0f;
+            }
+        }
+    }
+
+    // gw[o][i] += delta[r][o] * x[r][i] over the rows, in row order
+    static void weightGrad(float* gw, int in, int out, const float* x, const float* delta, int rows,
+                           std::size_t stride) {
+        for (int o = 0; o < out; o++) {
+            float* g = gw + (std::size_t)o * in;
+            for (int r = 0; r < rows; r++) {
+                float d = delta[(std::size_t)r * stride + o];
+                const float* xr = x + (std::size_t)r * stride;
+                for (int i = 0; i < in; i++) g[i] = g[i] + d * xr[i];
+            }
+        }
+    }
+
+    // prev = (delta W) where x > 0, else 0: the delta of the layer below
+    static void inputDelta(const float* w, int in, int out, const float* delta, const float* x, float* prev) {
+        for (int i = 0; i < in; i++) prev[i] = 0.0f;
+        for (int o = 0; o < out; o++) {
+            const float* wo = w + (std::size_t)o * in;
+            for (int i = 0; i < in; i++) prev[i] = prev[i] + wo[i] * delta[o];
+        }
+        for (int i = 0; i < in; i++) prev[i] = x[i] > 0.0f ? prev[i] : 0.0f;
+    }
+
+    static void add(float* y, const float* x, std::size_t n) {
+        for (std::size_t k = 0; k < n; k++) y[k] = y[k] + x[k];
+    }
+
+    static void adam(float* p, float* m, float* v, const float* g, std::size_t n, float stepSize,
+                     float correction) {
+        const float beta1 = 0.9f, beta2 = 0.999f, epsilon = 1e-8f;
+        for (std::size_t k = 0; k < n; k++) {
+            m[k] = beta1 * m[k] + (1.0f - beta1) * g[k];
+            v[k] = beta2 * v[k] + (1.0f - beta2) * g[k] * g[k];
+            p[k] = p[k] - (stepSize * m[k]) / (std::sqrt(v[k]) / correction + epsilon);
+        }
+    }
+};
+
+#ifdef DQN_X86
+
+struct Avx2Kernels {
+    // U blocks of 8 outputs of R rows, kept in registers across the inputs:
+    // a wide layer runs one row at a time, a narrow one several rows, so
+    // there are always independent sums in flight
+    template <int U, int R>
+    AVX2_TARGET static inline void forwardBlock(const float* wt, const float* bias, int in, int out,
+                                                const float* x, float* y, std::size_t stride, bool relu) {
+        __m256 acc[R][U];
+        for (int r = 0; r < R; r++) {
+            for (int u = 0; u < U; u++) acc[r][u] = _mm256_loadu_ps(bias + 8 * u);
+        }
+        for (int i = 0; i < in; i++) {
+            const float* w = wt + (std::size_t)i * out;
+            for (int r = 0; r < R; r++) {
+                __m256 xi = _mm256_set1_ps(x[(std::size_t)r * stride + i]);
+                for (int u = 0; u < U; u++) {
+                    acc[r][u] = _mm256_add_ps(acc[r][u], _mm256_mul_ps(xi, _mm256_loadu_ps(w + 8 * u)));
+                }
+            }
+        }
+        for (int r = 0; r < R; r++) {
+            for (int u = 0; u < U; u++) {
+                if (relu) acc[r][u] = _mm256_max_ps(acc[r][u], _mm256_setzero_ps());
+                _mm256_storeu_ps(y + (std::size_t)r * stride + 8 * u, acc[r][u]);
+            }
+        }
+    }
+
+    AVX2_TARGET static void forward(const float* wt, const float* bias, int in, int out, const float* x, float* y,
+                                    int rows, std::size_t stride, bool relu) {
+        int r = 0;
+        if (out < 64) {
+            for (; r + 4 <= rows; r += 4) {
+                const float* xr = x + (std::size_t)r * stride;
+                float* yr = y + (std::size_t)r * stride;
+                for (int o = 0; o < out; o += 8) forwardBlock<1, 4>(wt + o, bias + o, in, out, xr, yr + o, stride, relu);
+            }
+        }
+        for (; r < rows; r++) {
+            const float* xr = x + (std::size_t)r * stride;
+            float* yr = y + (std::size_t)r * stride;
+            int o = 0;
+            for (; o + 64 <= out; o += 64) forwardBlock<8, 1>(wt + o, bias + o, in, out, xr, yr + o, stride, relu);
+            for (; o < out; o += 8) forwardBlock<1, 1>(wt + o, bias + o, in, out, xr, yr + o, stride, relu);
+        }
+    }
+
+    template <int U>
+    AVX2_TARGET static inline void weightGradBlock(float* g, const float* x, const float* delta, int rows,
+                                                   std::size_t stride) {
+        __m256 acc[U];
+        for (int u = 0; u < U; u++) acc[u] = _mm256_loadu_ps(g + 8 * u);
+        for (int r = 0; r < rows; r++) {
+            __m256 d = _mm256_set1_ps(delta[(std::size_t)r * stride]);
+            const float* xr = x + (std::size_t)r * stride;
+            for (int u = 0; u < U; u++) acc[u] = _mm256_add_ps(acc[u], _mm256_mul_ps(d, _mm256_loadu_ps(xr + 8 * u)));
+        }
+        for (int u = 0; u < U; u++) _mm256_storeu_ps(g + 8 * u, acc[u]);
+    }
+
+    AVX2_TARGET static void weightGrad(float* gw, int in, int out, const float* x, const float* delta, int rows,
+                                       std::size_t stride) {
+        for (int o = 0; o < out; o++) {
+            float* g = gw + (std::size_t)o * in;
+            int i = 0;
+            for (; i + 64 <= in; i += 64) weightGradBlock<8>(g + i, x + i, delta + o, rows, stride);
+            for (; i < in; i += 8) weightGradBlock<1>(g + i, x + i, delta + o, rows, stride);
+        }
+    }
+
+    template <int U>
+    AVX2_TARGET static inline void inputDeltaBlock(const float* w, int in, int out, const float* delta,
+                                                   const float* x, float* prev) {
+        __m256 acc[U];
+        for (int u = 0; u < U; u++) acc[u] = _mm256_setzero_ps();
+        for (int o = 0; o < out; o++) {
+            __m256 d = _mm256_set1_ps(delta[o]);
+            const float* wo = w + (std::size_t)o * in;
+            for (int u = 0; u < U; u++) acc[u] = _mm256_add_ps(acc[u], _mm256_mul_ps(_mm256_loadu_ps(wo + 8 * u), d));
+        }
+        for (int u = 0; u < U; u++) {
+            __m256 active = _mm256_cmp_ps(_mm256_loadu_ps(x + 8 * u), _mm256_setzero_ps(), _CMP_GT_OQ);
+            _mm256_storeu_ps(prev + 8 * u, _mm256_and_ps(acc[u], active));
+        }
+    }
+
+    AVX2_TARGET static void inputDelta(const float* w, int in, int out, const float* delta, const float* x,
+                                       float* prev) {
+        int i = 0;
+        for (; i + 64 <= in; i += 64) inputDeltaBlock<8>(w + i, in, out, delta, x + i, prev + i);
+        for (; i < in; i += 8) inputDeltaBlock<1>(w + i, in, out, delta, x + i, prev + i);
+    }
+
+    AVX2_TARGET static void add(float* y, const float* x, std::size_t n) {
+        for (std::size_t k = 0; k < n; k += 8) {
+            _mm256_storeu_ps(y + k, _mm256_add_ps(_mm256_loadu_ps(y + k), _mm256_loadu_ps(x + k)));
+        }
+    }
+
+    AVX2_TARGET static void adam(float* p, float* m, float* v, const float* g, std::size_t n, float stepSize,
+                                 float correction) {
+        const __m256 beta1 = _mm256_set1_ps(0.9f), beta2 = _mm256_set1_ps(0.999f);
+        const __m256 rest1 = _mm256_set1_ps(1.0f - 0.9f), rest2 = _mm256_set1_ps(1.0f - 0.999f);
+        const __m256 epsilon = _mm256_set1_ps(1e-8f);
+        const __m256 step = _mm256_set1_ps(stepSize), corr = _mm256_set1_ps(correction);
+        for (std::size_t k = 0; k < n; k += 8) {
+            __m256 gk = _mm256_loadu_ps(g + k);
+            __m256 mk = _mm256_add_ps(_mm256_mul_ps(beta1, _mm256_loadu_ps(m + k)), _mm256_mul_ps(rest1, gk));
+            __m256 vk = _mm256_add_ps(_mm256_mul_ps(beta2, _mm256_loadu_ps(v + k)),
+                                      _mm256_mul_ps(_mm256_mul_ps(rest2, gk), gk));
+            __m256 denom = _mm256_add_ps(_mm256_div_ps(_mm256_sqrt_ps(vk), corr), epsilon);
+            __m256 pk = _mm256_sub_ps(_mm256_loadu_ps(p + k), _mm256_div_ps(_mm256_mul_ps(step, mk), denom));
+            _mm256_storeu_ps(m + k, mk);
+            _mm256_storeu_ps(v + k, vk);
+            _mm256_storeu_ps(p + k, pk);
+        }
+    }
+};
+
+#endif
+
+struct Shape {
+    int layers;
+    const int* padded;
+    const std::size_t* weightOffset;
+    const std::size_t* actOffset;
+    std::size_t actWidth;
+};
+
+template <typename K>
+void forwardRows(const Shape& s, const float* transposed, const float* params, float* acts, int rows) {
+    for (int l = 0; l < s.layers; l++) {
+        int in = s.padded[l], out = s.padded[l + 1];
+        const float* bias = params + s.weightOffset[l] + (std::size_t)out * in;
+        K::forward(transposed + s.weightOffset[l], bias, in, out, acts + s.actOffset[l], acts + s.actOffset[l + 1],
+                   rows, s.actWidth, l + 1 < s.layers);
+    }
+}
+
+// Adds the rows' gradient to grad, from the deltas (dLoss/dOutput) of the
+// last layer in place in their rows
+template <typename K>
+void backwardRows(const Shape& s, const float* params, const float* acts, float* deltas, int rows, float* grad) {
+    for (int l = s.layers - 1; l >= 0; l--) {
+        int in = s.padded[l], out = s.padded[l + 1];
+        float* gw = grad + s.weightOffset[l];
+        float* gb = gw + (std::size_t)out * in;
+        const float* delta = deltas + s.actOffset[l + 1];
+        K::weightGrad(gw, in, out, acts + s.actOffset[l], delta, rows, s.actWidth);
+        for (int r = 0; r < rows; r++) K::add(gb, delta + (std::size_t)r * s.actWidth, (std::size_t)out);
+        if (l == 0) break;
+        for (int r = 0; r < rows; r++) {
+            std::size_t row = (std::size_t)r * s.actWidth;
+            K::inputDelta(params + s.weightOffset[l], in, out, deltas + row + s.actOffset[l + 1],
+                          acts + row + s.actOffset[l], deltas + row + s.actOffset[l]);
+        }
+    }
+}
+
+// Flush denormals to zero while in scope
+class FlushDenormals {
+public:
+#ifdef DQN_X86
+    FlushDenormals() : saved(_mm_getcsr()) { _mm_setcsr(saved | 0x8040); } // FTZ and DAZ
+    ~FlushDenormals() { _mm_setcsr(saved); }
+
+private:
+    unsigned int saved;
+#endif
+};
+
+} // namespace
+
+/* ---------------------------------------------------------------------- */
+/* Trainer                                                                */
+/* ---------------------------------------------------------------------- */
+
+static int pad8(int width) {
+    return (width + 7) & ~7;
+}
+
+DqnTrainer::DqnTrainer(const DqnTrainConfig& config, const std::vector<int>& dims)
+    : config(config), kernel(dqnKernel()), dims(dims), eps(config.epsilonStart),
+      memory(config.memorySize, dims.front()) {
+    std::size_t offset = 0;
+    for (int width : dims) {
+        padded.push_back(pad8(width));
+        actOffset.push_back(actWidth);
+        actWidth += (std::size_t)padded.back();
+    }
+    for (std::size_t l = 0; l + 1 < dims.size(); l++) {
+        weightOffset.push_back(offset);
+        offset += (std::size_t)padded[l] * padded[l + 1] + padded[l + 1];
+    }
+
+    // PyTorch's initialization, spread into the padded layout
+    DqnModel init;
+    init.initRandom(dims, config.seed);
+    std::vector<float> weights = init.parameters();
+    const float* next = weights.data();
+    policy.params.assign(offset, 0.0f);
+    for (std::size_t l = 0; l + 1 < dims.size(); l++) {
+        int in = dims[l], out = dims[l + 1];
+        float* w = &policy.params[weightOffset[l]];
+        float* b = w + (std::size_t)padded[l + 1] * padded[l];
+        for (int o = 0; o < out; o++) {
+            std::memcpy(w + (std::size_t)o * padded[l], next, (std::size_t)in * sizeof(float));
+            next += in;
+        }
+        std::memcpy(b, next, (std::size_t)out * sizeof(float));
+        next += out;
+    }
+    transpose(policy);
+    target = policy;
+    adamM.assign(offset, 0.0f);
+    adamV.assign(offset, 0.0f);
+
+    // Its own stream, apart from the one initRandom() drew the weights from
+    rng_seed(&rng, config.seed);
+    rng_jump(&rng);
+    batch.assign((std::size_t)config.batchSize, 0);
+    actState.assign(actWidth, 0.0f);
+
+    int shardCount = (config.batchSize + DqnShardSize - 1) / DqnShardSize;
+    shards.resize((std::size_t)shardCount);
+    for (int s = 0; s < shardCount; s++) {
+        Shard& shard = shards[(std::size_t)s];
+        shard.acts.assign((std::size_t)DqnShardSize * actWidth, 0.0f);
+        shard.targetActs = shard.acts;
+        shard.deltas = shard.acts;
+        shard.grad.assign(offset, 0.0f);
+        shard.begin = s * DqnShardSize;
+        shard.end = std::min(config.batchSize, shard.begin + DqnShardSize);
+    }
+
+    // If a thread cannot start, training goes on with the ones that did
+    threadCount = std::max(1, std::min(config.threads, shardCount));
+    int requested = threadCount;
+    for (int t = 1; t < requested; t++) {
+        try {
+            pool.emplace_back(&DqnTrainer::worker, this, t);
+        } catch (const std::system_error&) {
+            break;
+        }
+    }
+    std::lock_guard<std::mutex> guard(lock);
+    threadCount = (int)pool.size() + 1;
+}
+
+DqnTrainer::~DqnTrainer() {
+    if (pool.empty()) return;
+    stop = true;
+    waitAll();
+    for (std::thread& thread : pool) thread.join();
+}
+
+void DqnTrainer::transpose(Net& net) {
+    net.transposed.resize(net.params.size());
+    for (std::size_t l = 0; l < weightOffset.size(); l++) {
+        int in = padded[l], out = padded[l + 1];
+        const float* w = net.params.data() + weightOffset[l];
+        float* wt = net.transposed.data() + weightOffset[l];
+        for (int o = 0; o < out; o++) {
+            for (int i = 0; i < in; i++) wt[(std::size_t)i * out + o] = w[(std::size_t)o * in + i];
+        }
+    }
+}
+
+void DqnTrainer::forward(const Net& net, float* acts, int rows) const {
+    Shape shape = {(int)weightOffset.size(), padded.data(), weightOffset.data(), actOffset.data(), actWidth};
+#ifdef DQN_X86
+    if (kernel == DqnKernel::Avx2) {
+        forwardRows<Avx2Kernels>(shape, net.transposed.data(), net.params.data(), acts, rows);
+        return;
+    }
+#endif
+    forwardRows<ScalarKernels>(shape, net.transposed.data(), net.params.data(), acts, rows);
+}
+
+int DqnTrainer::act(const float* state) {
+    int actions = dims.back();
+    if (rng_double(&rng) > eps) {
+        std::memcpy(actState.data(), state, (std::size_t)dims.front() * sizeof(float));
+        forward(policy, actState.data(), 1);
+        const float* q = actState.data() + actOffset.back();
+        int best = 0;
+        for (int a = 1; a < actions; a++) {
+            if (q[a] > q[best]) best = a;
+        }
+        return best;
+    }
+    return (int)rng_below(&rng, (uint32_t)actions);
+}
+
+void DqnTrainer::remember(const float* state, int action, float reward, const float* nextState, bool done) {
+    memory.push(state, action, reward, nextState, done);
+}
+
+// The loss is PyTorch's MSELoss over the batch of Q(state, action) against
+// reward + gamma * max Q_target(next state), the latter 0 at episode end
+void DqnTrainer::runShard(Shard& shard) {
+    int rows = shard.end - shard.begin;
+    int inputs = dims.front();
+    for (int r = 0; r < rows; r++) {
+        int i = batch[(std::size_t)(shard.begin + r)];
+        std::memcpy(&shard.acts[(std::size_t)r * actWidth], memory.state(i), (std::size_t)inputs * sizeof(float));
+        std::memcpy(&shard.targetActs[(std::size_t)r * actWidth], memory.nextState(i),
+                    (std::size_t)inputs * sizeof(float));
+    }
+    forward(policy, shard.acts.data(), rows);
+    forward(target, shard.targetActs.data(), rows);
+
+    int actions = dims.back();
+    float gamma = (float)config.gamma;
+    float scale = 2.0f / (float)config.batchSize;
+    std::size_t last = actOffset.back();
+    for (int r = 0; r < rows; r++) {
+        int i = batch[(std::size_t)(shard.begin + r)];
+        const float* q = &shard.acts[(std::size_t)r * actWidth + last];
+        const float* next = &shard.targetActs[(std::size_t)r * actWidth + last];
+        float maxNext = next[0];
+        for (int a = 1; a < actions; a++) maxNext = std::max(maxNext, next[a]);
+        float expected = memory.reward(i) + gamma * maxNext * (memory.done(i) ? 0.0f : 1.0f);
+
+        float* delta = &shard.deltas[(std::size_t)r * actWidth + last];
+        std::fill(delta, delta + padded.back(), 0.0f);
+        int action = memory.action(i);
+        delta[action] = scale * (q[action] - expected);
+    }
+
+    Shape shape = {(int)weightOffset.size(), padded.data(), weightOffset.data(), actOffset.data(), actWidth};
+    std::fill(shard.grad.begin(), shard.grad.end(), 0.0f);
+#ifdef DQN_X86
+    if (kernel == DqnKernel::Avx2) {
+        backwardRows<Avx2Kernels>(shape, policy.params.data(), shard.acts.data(), shard.deltas.data(), rows,
+                                  shard.grad.data());
+        return;
+    }
+#endif
+    backwardRows<ScalarKernels>(shape, policy.params.data(), shard.acts.data(), shard.deltas.data(), rows,
+                                shard.grad.data());
+}
+
+void DqnTrainer::runShards(int thread) {
+    for (std::size_t s = (std::size_t)thread; s < shards.size(); s += (std::size_t)threadCount) {
+        runShard(shards[s]);
+    }
+}
+
+bool DqnTrainer::optimize() {
+    if (memory.size() < config.batchSize) return false;
+    FlushDenormals flush;
+    memory.sample(&rng, config.batchSize, batch.data());
+
+    if (threadCount > 1) {
+        waitAll();
+        runShards(0);
+        waitAll();
+    } else {
+        runShards(0);
+    }
+
+    // Sum the shards in order, then Adam as torch.optim.Adam does it
+    std::vector<float>& grad = shards[0].grad;
+    adamStep++;
+    float stepSize = (float)(config.learningRate / (1.0 - std::pow(0.9, (double)adamStep)));
+    float correction = (float)std::sqrt(1.0 - std::pow(0.999, (double)adamStep));
+#ifdef DQN_X86
+    if (kernel == DqnKernel::Avx2) {
+        for (std::size_t s = 1; s < shards.size(); s++) Avx2Kernels::add(grad.data(), shards[s].grad.data(), grad.size());
+        Avx2Kernels::adam(policy.params.data(), adamM.data(), adamV.data(), grad.data(), grad.size(), stepSize,
+                          correction);
+    } else
+#endif
+    {
+        for (std::size_t s = 1; s < shards.size(); s++) {
+            ScalarKernels::add(grad.data(), shards[s].grad.data(), grad.size());
+        }
+        ScalarKernels::adam(policy.params.data(), adamM.data(), adamV.data(), grad.data(), grad.size(), stepSize,
+                            correction);
+    }
+    transpose(policy);
+
+    eps = std::max(config.epsilonEnd, eps * config.epsilonDecay);
+    return true;
+}
+
+void DqnTrainer::syncTarget() {
+    target = policy;
+}
+
+DqnModel DqnTrainer::model() const {
+    std::vector<float> weights;
+    for (std::size_t l = 0; l + 1 < dims.size(); l++) {
+        const float* w = &policy.params[weightOffset[l]];
+        const float* b = w + (std::size_t)padded[l + 1] * padded[l];
+        for (int o = 0; o < dims[l + 1]; o++) {
+            const float* row = w + (std::size_t)o * padded[l];
+            weights.insert(weights.end(), row, row + dims[l]);
+        }
+        weights.insert(weights.end(), b, b + dims[l + 1]);
+    }
+    DqnModel model;
+    model.setParameters(dims, weights);
+    return model;
+}
+
+void DqnTrainer::waitAll() {
+    std::unique_lock<std::mutex> guard(lock);
+    long waitingFor = generation;
+    if (++arrived == threadCount) {
+        arrived = 0;
+        generation++;
+        cond.notify_all();
+    } else {
+        cond.wait(guard, [&] { return generation != waitingFor; });
+    }
+}
+
+void DqnTrainer::worker(int index) {
+    FlushDenormals flush;
+    for (;;) {
+        waitAll();
+        if (stop) return;
+        runShards(index);
+        waitAll();
+    }
+}
@@ -0,0 +1,189 @@
+#ifndef DQN_TRAIN_H
+#define DQN_TRAIN_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "dqn.h"
+#include "rng.h"
+
+// Training for the DQN of Deep_Q_RL_based_Simulator.py, without Python.
+//
+// train_scheduler() there runs one optimization step per environment step:
+// it samples a batch from a deque of namedtuples, stacks it into fresh
+// tensors and runs PyTorch. Here the replay memory is one preallocated
+// ring of columns, and the MLP's forward pass, backward pass and Adam step
+// are written out over flat float arrays, so a step allocates nothing.
+//
+// The batch is cut into shards of DqnShardSize transitions. Each shard's
+// gradient is summed in its own buffer, by whichever thread gets it, and
+// the buffers are added in shard order, so training gives the same bits
+// with any number of threads. The layers are padded to multiples of 8 and
+// run with the kernel dqnKernel() picks; the AVX2 kernels do the scalar
+// kernels' operations in the same order, so DQN_KERNEL=scalar trains the
+// same network. Optimization runs with denormals flushed to zero: Adam's
+// second moments and small gradients would otherwise fall into them and
+// slow every step several times over.
+
+constexpr int DqnShardSize = 8;
+
+// The hyperparameters of Deep_Q_RL_based_Simulator.py
+struct DqnTrainConfig {
+    double gamma = 0.99;
+    int batchSize = 64;
+    double epsilonStart = 1.0;
+    double epsilonEnd = 0.01;
+    double epsilonDecay = 0.995;  // per optimization step
+    double learningRate = 0.001;  // Adam, PyTorch's betas and eps
+    int memorySize = 10000;
+    int threads = 1;
+    uint64_t seed = 1;
+};
+
+// Transitions in columns, oldest overwritten first
+class ReplayRing {
+public:
+    ReplayRing(int capacity, int stateSize);
+
+    void push(const float* state, int action, float reward, const float* nextState, bool done);
+    int size() const { return count; }
+
+    // `n` distinct indices, n <= size(), as random.sample() draws them
+    void sample(Rng* rng, int n, int* out) const;
+
+    const float* state(int i) const { return &states[(std::size_t)i * stateSize]; }
+    const float* nextState(int i) const { return &nextStates[(std::size_t)i * stateSize]; }
+    int action(int i) const { return actions[i]; }
+    float reward(int i) const { return rewards[i]; }
+    bool done(int i) const { return dones[i] != 0; }
+
+private:
+    int capacity;
+    int stateSize;
+    int head = 0; // next slot written
+    int count = 0;
+    std::vector<float> states;
+    std::vector<float> nextStates;
+    std::vector<int32_t> actions;
+    std::vector<float> rewards;
+    std::vector<unsigned char> dones;
+};
+
+// CPUEnvironment of Deep_Q_RL_based_Simulator.py: NUM_PROCESSES processes,
+// the state is their mean features, the action is the process to run for
+// one tick, and the episode ends when every burst is used up. Processes
+// are drawn from the same ranges with the simulator's Rng.
+class DqnEnv {
+public:
+    static constexpr int Features = DqnPolicy::Features;
+
+    DqnEnv(int processes, uint64_t seed);
+
+    void reset();
+    void state(float* out) const;
+    // Runs `action` for a tick; returns true when the episode is over
+    bool step(int action, float* reward);
+
+    int processes() const { return (int)procs.size(); }
+    double meanWaiting() const;
+
+private:
+    struct Proc {
+        int priority;   // 1-10
+        int burst;      // 1-20, remaining
+        int waiting;
+        int ioBound;    // 0 or 1
+        int memory;     // 1-100
+        int inCpu;
+    };
+
+    Rng rng;
+    std::vector<Proc> procs;
+};
+
+class DqnTrainer {
+public:
+    // A policy network of the given widths with PyTorch's initialization,
+    // and its target network a copy of it
+    DqnTrainer(const DqnTrainConfig& config, const std::vector<int>& dims);
+    ~DqnTrainer();
+    DqnTrainer(const DqnTrainer&) = delete;
+    DqnTrainer& operator=(const DqnTrainer&) = delete;
+
+    // Epsilon-greedy action of the policy network
+    int act(const float* state);
+    void remember(const float* state, int action, float reward, const float* nextState, bool done);
+    // One Adam step on a sampled batch, and one epsilon decay; false while
+    // the memory holds less than a batch
+    bool optimize();
+    void syncTarget();
+
+    double epsilon() const { return eps; }
+    int threads() const { return threadCount; }
+    // The policy network, to save or to run with DqnPolicy
+    DqnModel model() const;
+
+private:
+    // Every layer padded to multiples of 8 inputs and outputs, with zeros
+    // that training keeps at zero
+    struct Net {
+        std::vector<float> params;     // per layer weights (out x in), then biases
+        std::vector<float> transposed; // per layer weights in x out, for the forward pass
+    };
+
+    // Activations, deltas and the gradient of one shard, rows of actWidth
+    // floats: the input, then every layer's outputs
+    struct Shard {
+        std::vector<float> acts;
+        std::vector<float> targetActs;
+        std::vector<float> deltas;
+        std::vector<float> grad;
+        int begin;
+        int end;
+    };
+
+    void transpose(Net& net);
+    // Rows of acts with the input in place
+    void forward(const Net& net, float* acts, int rows) const;
+    void runShard(Shard& shard);
+    void runShards(int thread);
+
+    // Workers wait at the barrier for a batch, run their shards, and wait
+    // again, as mc_run() drives its cores
+    void waitAll();
+    void worker(int index);
+
+    DqnTrainConfig config;
+    DqnKernel kernel;
+    std::vector<int> dims;
+    std::vector<int> padded;               // dims rounded up to 8
+    std::vector<std::size_t> weightOffset; // into params, per layer
+    std::vector<std::size_t> actOffset;    // into a row of acts, per width
+    std::size_t actWidth = 0;
+
+    Net policy;
+    Net target;
+    std::vector<float> adamM;
+    std::vector<float> adamV;
+    long adamStep = 0;
+    double eps;
+
+    ReplayRing memory;
+    Rng rng;
+    std::vector<int> batch;
+    std::vector<float> actState;
+    std::vector<Shard> shards;
+
+    int threadCount = 1;
+    std::vector<std::thread> pool;
+    std::mutex lock;
+    std::condition_variable cond;
+    int arrived = 0;
+    long generation = 0;
+    bool stop = false;
+};
+
+#endif // DQN_TRAIN_H
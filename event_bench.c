@@ -0,0 +1,152 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "event_queue.h"
+#include "rng.h"
+#include "timing_wheel.h"
+
+// Hold-model benchmark of the simulator's clock: fill a queue with N
+// pending events, then repeatedly remove the earliest one and schedule a
+// new one a random delay later, so N stay pending. Runs the timing wheel
+// and the binary heap on the same random delays and reports events per
+// second (one pop and one push each). Both must hand out the same events
+// in the same order; a digest of the sequence checks that they do.
+
+#define MAX_SIZES 8
+
+typedef struct {
+    long sizes[MAX_SIZES];
+    int size_count;
+    long operations;
+    int horizon;    // delays are uniform in [0, horizon)
+    uint64_t seed;
+} EventBenchConfig;
+
+typedef struct {
+    double fill_seconds;
+    double events_per_second;
+    uint64_t digest;
+} QueueResult;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static inline uint64_t mix(uint64_t digest, int time, int value) {
+    return (digest ^ (((uint64_t)(uint32_t)time << 32) | (uint32_t)value)) * 0x100000001b3ull;
+}
+
+static bool run_wheel(const EventBenchConfig *config, int pending, QueueResult *result) {
+    TimingWheel w;
+    timing_wheel_init(&w);
+    Rng rng;
+    rng_seed(&rng, config->seed);
+
+    double start = now_seconds();
+    for (int i = 0; i < pending; i++) {
+        timing_wheel_push(&w, (int)rng_below(&rng, (uint32_t)config->horizon), i);
+    }
+    result->fill_seconds = now_seconds() - start;
+
+    uint64_t digest = 0;
+    int time, value;
+    start = now_seconds();
+    for (long op = 0; op < config->operations; op++) {
+        timing_wheel_pop(&w, &time, &value);
+        digest = mix(digest, time, value);
+        timing_wheel_push(&w, time + (int)rng_below(&rng, (uint32_t)config->horizon), value);
+    }
+    result->events_per_second = config->operations / (now_seconds() - start);
+    result->digest = digest;
+    timing_wheel_free(&w);
+    return true;
+}
+
+static bool run_heap(const EventBenchConfig *config, int pending, QueueResult *result) {
+    EventQueue q;
+    if (!event_queue_init(&q, pending)) return false;
+    Rng rng;
+    rng_seed(&rng, config->seed);
+
+    double start = now_seconds();
+    for (int i = 0; i < pending; i++) {
+        event_queue_push(&q, (int)rng_below(&rng, (uint32_t)config->horizon), i);
+    }
+    result->fill_seconds = now_seconds() - start;
+
+    uint64_t digest = 0;
+    start = now_seconds();
+    for (long op = 0; op < config->operations; op++) {
+        int time = event_queue_next_time(&q);
+        int value = event_queue_pop(&q);
+        digest = mix(digest, time, value);
+        event_queue_push(&q, time + (int)rng_below(&rng, (uint32_t)config->horizon), value);
+    }
+    result->events_per_second = config->operations / (now_seconds() - start);
+    result->digest = digest;
+    event_queue_free(&q);
+    return true;
+}
+
+static void usage(const char *program) {
+    fprintf(stderr, "Usage: %s [--pending N[,N...]] [--operations N] [--horizon T] [--seed N]\n", program);
+    exit(EXIT_FAILURE);
+}
+
+static void parse_sizes(EventBenchConfig *config, char *list, const char *program) {
+    config->size_count = 0;
+    for (char *item = strtok(list, ","); item != NULL; item = strtok(NULL, ",")) {
+        if (config->size_count == MAX_SIZES) usage(program);
+        config->sizes[config->size_count++] = atol(item);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    EventBenchConfig config = {{1000000, 10000000, 100000000}, 3, 10000000, 1 << 20, 1};
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) usage(argv[0]);
+        char *value = argv[++i];
+        if (strcmp(argv[i - 1], "--pending") == 0) parse_sizes(&config, value, argv[0]);
+        else if (strcmp(argv[i - 1], "--operations") == 0) config.operations = atol(value);
+        else if (strcmp(argv[i - 1], "--horizon") == 0) config.horizon = atoi(value);
+        else if (strcmp(argv[i - 1], "--seed") == 0) config.seed = strtoull(value, NULL, 0);
+        else usage(argv[0]);
+    }
+    if (config.size_count < 1 || config.operations < 1 || config.horizon < 1) usage(argv[0]);
+    for (int s = 0; s < config.size_count; s++) {
+        if (config.sizes[s] < 1 || config.sizes[s] > INT32_MAX / 2) usage(argv[0]);
+    }
+
+    printf("%ld operations per run, delays in [0, %d), seed %llu\n\n", config.operations,
+           config.horizon, (unsigned long long)config.seed);
+    printf("%12s %-6s %10s %14s\n", "Pending", "Queue", "Fill s", "Events/s");
+    int status = EXIT_SUCCESS;
+    for (int s = 0; s < config.size_count; s++) {
+        int pending = (int)config.sizes[s];
+        if ((double)config.operations * config.horizon / pending > INT32_MAX / 2) {
+            // The clock advances about horizon / 2 / pending per operation
+            fprintf(stderr, "%12d: the clock would overflow, skipped\n", pending);
+            continue;
+        }
+        QueueResult wheel, heap;
+        if (!run_wheel(&config, pending, &wheel) || !run_heap(&config, pending, &heap)) {
+            fprintf(stderr, "%12d: not enough memory, skipped\n", pending);
+            continue;
+        }
+        printf("%12d %-6s %10.3f %14.0f\n", pending, "wheel", wheel.fill_seconds, wheel.events_per_second);
+        printf("%12d %-6s %10.3f %14.0f   (wheel %.2fx)\n", pending, "heap", heap.fill_seconds,
+               heap.events_per_second, wheel.events_per_second / heap.events_per_second);
+        if (wheel.digest != heap.digest) {
+            fprintf(stderr, "%12d: the wheel and the heap dispatched different events\n", pending);
+            status = EXIT_FAILURE;
+        }
+    }
+    return status;
+}
@@ -0,0 +1,66 @@
+#include <stdlib.h>
+#include "event_queue.h"
+
+bool event_queue_init(EventQueue *q, int capacity) {
+    q->events = NULL;
+    q->size = 0;
+    q->capacity = 0;
+    q->next_seq = 0;
+    if (capacity <= 0) return true;
+
+    q->events = malloc((size_t)capacity * sizeof(Event));
+    if (q->events == NULL) return false;
+    q->capacity = capacity;
+    return true;
+}
+
+void event_queue_free(EventQueue *q) {
+    free(q->events);
+    q->events = NULL;
+    q->size = 0;
+    q->capacity = 0;
+}
+
+static inline bool before(const Event *a, const Event *b) {
+    if (a->time != b->time) return a->time < b->time;
+    return a->seq < b->seq;
+}
+
+bool event_queue_push(EventQueue *q, int time, int value) {
+    if (q->size == q->capacity) {
+        int capacity = q->capacity > 0 ? q->capacity * 2 : 16;
+        Event *events = realloc(q->events, (size_t)capacity * sizeof(Event));
+        if (events == NULL) return false;
+        q->events = events;
+        q->capacity = capacity;
+    }
+
+    Event event = {time, q->next_seq++, value};
+    int i = q->size++;
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!before(&event, &q->events[parent])) break;
+        q->events[i] = q->events[parent];
+        i = parent;
+    }
+    q->events[i] = event;
+    return true;
+}
+
+// Remove the earliest event and return its value; the queue must not be
+// empty
+int event_queue_pop(EventQueue *q) {
+    int value = q->events[0].value;
+    Event last = q->events[--q->size];
+    int i = 0;
+    for (;;) {
+        int child = 2 * i + 1;
+        if (child >= q->size) break;
+        if (child + 1 < q->size && before(&q->events[child + 1], &q->events[child])) child++;
+        if (!before(&q->events[child], &last)) break;
+        q->events[i] = q->events[child];
+        i = child;
+    }
+    if (q->size > 0) q->events[i] = last;
+    return value;
+}
@@ -0,0 +1,43 @@
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Min-heap of timed events. Events due at the same time come out in the
+// order they were pushed.
+typedef struct {
+    int time;
+    int seq;    // push order, breaks ties
+    int value;
+} Event;
+
+typedef struct {
+    Event *events;
+    int size;
+    int capacity;
+    int next_seq;
+} EventQueue;
+
+bool event_queue_init(EventQueue *q, int capacity);
+void event_queue_free(EventQueue *q);
+bool event_queue_push(EventQueue *q, int time, int value);
+int event_queue_pop(EventQueue *q);
+
+static inline bool event_queue_empty(const EventQueue *q) {
+    return q->size == 0;
+}
+
+// Time of the earliest event; the queue must not be empty
+static inline int event_queue_next_time(const EventQueue *q) {
+    return q->events[0].time;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // EVENT_QUEUE_H
@@ -0,0 +1,300 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "q_fixed.h"
+#include "q_scheduler.h"
+#include "sim_engine.h"
+
+// The integer Q-table path (q_fixed.h) against the float one.
+//
+// Accuracy: seeded episodes run on the float engine, and at every decision
+// point the fixed-point path sweeps its own rows with the same features,
+// so its error accumulates over the whole run as it would in a kernel. It
+// reports the largest and mean difference of the Q values, how often both
+// paths pick the same process, and, when they do not, how far below the
+// best float score the fixed-point choice is.
+//
+// Latency: the time of one decision, a sweep of every row and the pick of
+// the best, for each number of ready processes, on the float path (the
+// SIMD reward and update kernels and the ready-queue heap) and on the
+// integer path (one scalar pass).
+
+_Static_assert(QFIX_STATES == MAX_STATES, "the integer rows have the store's states");
+
+#define MAX_SIZES 8
+
+typedef struct {
+    int episodes;
+    int processes;
+    uint64_t seed;
+    int sizes[MAX_SIZES];
+    int size_count;
+    long decisions; // per size in the latency runs
+} FixedBenchConfig;
+
+typedef struct {
+    qfix (*rows)[QFIX_STATES]; // [slot]
+    int64_t *scores;           // [slot]
+    int capacity;
+
+    double max_error;          // largest |fixed - float| of a Q value
+    double max_relative;       // the same over max(1, |float|)
+    double error_sum;
+    long values;
+    long decisions;
+    long agreed;               // same process picked
+    long tied;                 // a different process with the same float score
+    double max_regret;         // best float score minus the fixed choice's
+} Comparison;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static QFixFeatures store_features(const ProcessStore *store, int slot) {
+    QFixFeatures f;
+    f.priority = store->system_priority[slot];
+    f.burst = store->burst_time[slot];
+    f.waiting = store_waiting_time(store, slot);
+    f.cpu_percent = (int32_t)lrintf(store->cpu_utilization[slot] * 100.0f);
+    f.memory_percent = (int32_t)lrintf(store->memory_usage[slot] * 100.0f);
+    return f;
+}
+
+static void grow_rows(Comparison *c, int count) {
+    if (count <= c->capacity) return;
+    int capacity = c->capacity > 0 ? c->capacity : 64;
+    while (capacity < count) capacity *= 2;
+    qfix (*rows)[QFIX_STATES] = realloc(c->rows, (size_t)capacity * sizeof(*rows));
+    int64_t *scores = realloc(c->scores, (size_t)capacity * sizeof(*scores));
+    if (rows == NULL || scores == NULL) {
+        perror("Error allocating rows");
+        exit(EXIT_FAILURE);
+    }
+    // Admitted processes start from zero rows, as initialize_q_table() leaves them
+    memset(rows + c->capacity, 0, (size_t)(capacity - c->capacity) * sizeof(*rows));
+    c->rows = rows;
+    c->scores = scores;
+    c->capacity = capacity;
+}
+
+// At the decision point the float sweep has just run on the store as it
+// is now: run the integer sweep on the same features and compare
+static void on_step(const SimEngine *sim, void *user_data) {
+    Comparison *c = user_data;
+    const ProcessStore *store = &sim->store;
+    grow_rows(c, store->count);
+
+    for (int k = 0; k < store->active_count; k++) {
+        int slot = store->active[k];
+        QFixFeatures f = store_features(store, slot);
+        c->scores[slot] = qfix_update_row(c->rows[slot], qfix_reward(&f));
+        for (int j = 0; j < MAX_STATES; j++) {
+            double expected = store->q_table[slot][j];
+            double error = fabs((double)c->rows[slot][j] / QFIX_ONE - expected);
+            double relative = error / (fabs(expected) > 1.0 ? fabs(expected) : 1.0);
+            if (error > c->max_error) c->max_error = error;
+            if (relative > c->max_relative) c->max_relative = relative;
+            c->error_sum += error;
+            c->values++;
+        }
+    }
+
+    int chosen = qfix_select(c->scores, store->active, store->active_count);
+    if (chosen < 0 || sim->selected < 0 || store->completed[sim->selected]) return;
+    c->decisions++;
+    if (chosen == sim->selected) {
+        c->agreed++;
+        return;
+    }
+    double best = store->ready_queue.score[sim->selected];
+    double regret = best - store->ready_queue.score[chosen];
+    if (regret == 0.0) c->tied++;
+    if (regret > c->max_regret) c->max_regret = regret;
+}
+
+static void run_accuracy(const FixedBenchConfig *config) {
+    Comparison c;
+    memset(&c, 0, sizeof(c));
+    Process *workload = malloc((size_t)config->processes * sizeof(Process));
+    if (workload == NULL) {
+        perror("Error allocating workload");
+        exit(EXIT_FAILURE);
+    }
+
+    Rng stream;
+    rng_seed(&stream, config->seed);
+    double start = now_seconds();
+    for (int e = 0; e < config->episodes; e++) {
+        Rng rng = stream;
+        rng_jump(&stream);
+        generate_processes(workload, config->processes, 0, &rng);
+
+        SimEngine sim;
+        if (!sim_init(&sim, config->processes)) {
+            perror("Error allocating simulation");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < config->processes; i++) {
+            sim_add_process(&sim, workload[i]);
+        }
+        sim_set_rng(&sim, &rng);
+        memset(c.rows, 0, (size_t)c.capacity * sizeof(*c.rows));
+        sim_set_step_callback(&sim, on_step, &c);
+        while (sim_step(&sim)) {
+        }
+        sim_free(&sim);
+    }
+
+    printf("Accuracy: %d episodes x %d processes, seed %llu, %.1f s\n", config->episodes, config->processes,
+           (unsigned long long)config->seed, now_seconds() - start);
+    printf("  Q values compared  %ld\n", c.values);
+    printf("  max |error|        %.6f  (%.2f units of 2^-%d)\n", c.max_error, c.max_error * QFIX_ONE,
+           QFIX_FRAC_BITS);
+    printf("  mean |error|       %.6f\n", c.values > 0 ? c.error_sum / c.values : 0.0);
+    printf("  max relative error %.3g\n", c.max_relative);
+    printf("  decisions          %ld, same process %.4f%%, tied %ld, max regret %.6f\n\n", c.decisions,
+           c.decisions > 0 ? 100.0 * c.agreed / c.decisions : 0.0, c.tied, c.max_regret);
+
+    free(c.rows);
+    free(c.scores);
+    free(workload);
+}
+
+// Ready processes with some history, so the rows are not all zero
+static void fill_store(ProcessStore *store, int n, Rng *rng) {
+    Process *workload = malloc((size_t)n * sizeof(Process));
+    if (workload == NULL || !store_init(store, n)) {
+        perror("Error allocating store");
+        exit(EXIT_FAILURE);
+    }
+    generate_processes(workload, n, 0, rng);
+    for (int i = 0; i < n; i++) {
+        workload[i].waiting_time = (int)rng_below(rng, 4096);
+        int slot = store_add(store, workload[i]);
+        if (slot < 0 || !qheap_update(&store->ready_queue, slot, 0.0f)) {
+            perror("Error allocating store");
+            exit(EXIT_FAILURE);
+        }
+    }
+    initialize_q_table(store);
+    free(workload);
+}
+
+// Nanoseconds per decision of both paths on n ready processes. After each
+// decision the clock moves a quantum and the selected process rejoins the
+// queue, so waiting times and the winner move as they would in a run;
+// nothing completes.
+static void run_latency(const FixedBenchConfig *config, int n) {
+    Rng rng;
+    rng_seed(&rng, config->seed);
+    ProcessStore store;
+    fill_store(&store, n, &rng);
+    QFixFeatures *features = malloc((size_t)n * sizeof(QFixFeatures));
+    qfix (*rows)[QFIX_STATES] = calloc((size_t)n, sizeof(*rows));
+    int64_t *scores = malloc((size_t)n * sizeof(int64_t));
+    int *slots = malloc((size_t)n * sizeof(int));
+    if (features == NULL || rows == NULL || scores == NULL || slots == NULL) {
+        perror("Error allocating rows");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++) {
+        features[i] = store_features(&store, i);
+        slots[i] = i;
+    }
+
+    // Float: the sweep and pick sim_step() makes between quanta
+    double start = now_seconds();
+    for (long d = 0; d < config->decisions; d++) {
+        update_q_table_incremental(&store);
+        int selected = select_action(&store);
+        store.waiting_time[selected] = store_waiting_time(&store, selected);
+        store.clock += TIME_QUANTUM;
+        store.enqueued_at[selected] = store.clock;
+    }
+    double float_ns = (now_seconds() - start) * 1e9 / config->decisions;
+
+    // Integer: the same on the integer rows, with waiting times kept the
+    // same way
+    int32_t clock = 0;
+    int32_t *queued_at = calloc((size_t)n, sizeof(int32_t));
+    int32_t *waited = malloc((size_t)n * sizeof(int32_t));
+    if (queued_at == NULL || waited == NULL) {
+        perror("Error allocating rows");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < n; i++) waited[i] = features[i].waiting;
+    start = now_seconds();
+    for (long d = 0; d < config->decisions; d++) {
+        for (int i = 0; i < n; i++) {
+            features[i].waiting = waited[i] + clock - queued_at[i];
+            scores[i] = qfix_update_row(rows[i], qfix_reward(&features[i]));
+        }
+        int selected = qfix_select(scores, slots, n);
+        waited[selected] += clock - queued_at[selected];
+        clock += TIME_QUANTUM;
+        queued_at[selected] = clock;
+    }
+    double fixed_ns = (now_seconds() - start) * 1e9 / config->decisions;
+
+    printf("%10d %14.0f %14.0f %12.2f %12.2f\n", n, float_ns, fixed_ns, float_ns / n, fixed_ns / n);
+    store_free(&store);
+    free(features);
+    free(rows);
+    free(scores);
+    free(slots);
+    free(queued_at);
+    free(waited);
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [--episodes N] [--processes N] [--seed N] [--sizes N[,N...]] [--decisions N]\n",
+            program);
+    exit(EXIT_FAILURE);
+}
+
+static void parse_sizes(FixedBenchConfig *config, char *list, const char *program) {
+    config->size_count = 0;
+    for (char *item = strtok(list, ","); item != NULL; item = strtok(NULL, ",")) {
+        if (config->size_count == MAX_SIZES) usage(program);
+        config->sizes[config->size_count++] = atoi(item);
+    }
+}
+
+int main(int argc, char *argv[]) {
+    FixedBenchConfig config = {20, 1000, 1, {16, 64, 256, 1024, 4096}, 5, 20000};
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) usage(argv[0]);
+        char *value = argv[++i];
+        if (strcmp(argv[i - 1], "--episodes") == 0) config.episodes = atoi(value);
+        else if (strcmp(argv[i - 1], "--processes") == 0) config.processes = atoi(value);
+        else if (strcmp(argv[i - 1], "--seed") == 0) config.seed = strtoull(value, NULL, 0);
+        else if (strcmp(argv[i - 1], "--sizes") == 0) parse_sizes(&config, value, argv[0]);
+        else if (strcmp(argv[i - 1], "--decisions") == 0) config.decisions = atol(value);
+        else usage(argv[0]);
+    }
+    if (config.episodes < 0 || config.processes < 1 || config.size_count < 1 || config.decisions < 1) {
+        usage(argv[0]);
+    }
+    for (int s = 0; s < config.size_count; s++) {
+        if (config.sizes[s] < 1) usage(argv[0]);
+    }
+
+    if (config.episodes > 0) run_accuracy(&config);
+
+    printf("Latency: %ld decisions per size, seed %llu\n", config.decisions, (unsigned long long)config.seed);
+    printf("%10s %14s %14s %12s %12s\n", "Processes", "Float ns", "Integer ns", "Float/proc", "Int/proc");
+    for (int s = 0; s < config.size_count; s++) {
+        run_latency(&config, config.sizes[s]);
+    }
+    return 0;
+}
@@ -0,0 +1,288 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include "multicore.h"
+#include "q_scheduler.h"
+
+bool mc_init(MultiCoreSim *sim, int cores) {
+    memset(sim, 0, sizeof(*sim));
+    timing_wheel_init(&sim->events);
+    if (cores < 1) {
+        errno = EINVAL;
+        return false;
+    }
+
+    sim->cores = calloc((size_t)cores, sizeof(McCore));
+    if (sim->cores == NULL) return false;
+    sim->core_count = cores;
+    for (int c = 0; c < cores; c++) {
+        if (!store_init(&sim->cores[c].store, 0)) return false;
+    }
+    mc_seed(sim, 0);
+    return true;
+}
+
+// Add a process before the run. One present at the start goes to the next
+// core in turn; a later one becomes an arrival event.
+bool mc_add_process(MultiCoreSim *sim, Process p) {
+    if (p.arrival_time <= 0) {
+        McCore *core = &sim->cores[sim->next_core];
+        sim->next_core = (sim->next_core + 1) % sim->core_count;
+        return store_add(&core->store, p) >= 0;
+    }
+
+    if (sim->arrival_count == sim->arrival_capacity) {
+        int capacity = sim->arrival_capacity > 0 ? sim->arrival_capacity * 2 : 16;
+        Process *arrivals = realloc(sim->arrivals, (size_t)capacity * sizeof(Process));
+        if (arrivals == NULL) return false;
+        sim->arrivals = arrivals;
+        sim->arrival_capacity = capacity;
+    }
+    if (!timing_wheel_push(&sim->events, p.arrival_time, sim->arrival_count)) return false;
+    sim->arrivals[sim->arrival_count++] = p;
+    return true;
+}
+
+void mc_seed(MultiCoreSim *sim, uint64_t seed) {
+    Rng rng;
+    rng_seed(&rng, seed);
+    mc_set_rng(sim, &rng);
+}
+
+void mc_set_rng(MultiCoreSim *sim, const Rng *rng) {
+    Rng stream = *rng;
+    for (int c = 0; c < sim->core_count; c++) {
+        sim->cores[c].rng = stream;
+        rng_jump(&stream);
+    }
+}
+
+static bool any_ready(const MultiCoreSim *sim) {
+    for (int c = 0; c < sim->core_count; c++) {
+        if (sim->cores[c].store.ready_queue.size > 0) return true;
+    }
+    return false;
+}
+
+// Core with the fewest (least_ready) or most ready processes, the lowest
+// numbered on ties
+static McCore *pick_core(MultiCoreSim *sim, bool least_ready) {
+    McCore *best = &sim->cores[0];
+    for (int c = 1; c < sim->core_count; c++) {
+        int size = sim->cores[c].store.ready_queue.size;
+        if (least_ready ? size < best->store.ready_queue.size : size > best->store.ready_queue.size) {
+            best = &sim->cores[c];
+        }
+    }
+    return best;
+}
+
+static bool admit_arrival(MultiCoreSim *sim, int arrival) {
+    Process p = sim->arrivals[arrival];
+    p.waiting_time += sim->time - p.arrival_time;
+    ProcessStore *store = &pick_core(sim, true)->store;
+    int slot = store_add(store, p);
+    if (slot < 0 || (!p.completed && !qheap_update(&store->ready_queue, slot, 0.0f))) {
+        errno = ENOMEM;
+        return false;
+    }
+    sim->admitted++;
+    return true;
+}
+
+// Admit the arrivals due by now. With nothing ready on any core, jump the
+// clock to the next arrival.
+static bool run_arrivals(MultiCoreSim *sim) {
+    int time, arrival;
+    for (;;) {
+        if (!timing_wheel_pop_until(&sim->events, sim->time, &time, &arrival)) {
+            if (any_ready(sim) || !timing_wheel_pop(&sim->events, &time, &arrival)) break;
+            sim->time = time;
+        }
+        if (!admit_arrival(sim, arrival)) return false;
+    }
+    return true;
+}
+
+// Move a ready process, with its Q row and score, from one core to another
+static bool migrate(McCore *from, int slot, McCore *to) {
+    ProcessStore *source = &from->store;
+    ProcessStore *target = &to->store;
+    int moved = store_add(target, store_get(source, slot));
+    if (moved < 0 || !qheap_update(&target->ready_queue, moved, source->ready_queue.score[slot])) {
+        errno = ENOMEM;
+        return false;
+    }
+    memcpy(target->q_table[moved], source->q_table[slot], sizeof(*target->q_table));
+    store_remove(source, slot);
+    to->stolen++;
+    return true;
+}
+
+// Every core with nothing ready steals half of the busiest core's ready
+// processes, from the tail of its heap
+static bool balance(MultiCoreSim *sim) {
+    for (int c = 0; c < sim->core_count; c++) {
+        McCore *thief = &sim->cores[c];
+        if (thief->store.ready_queue.size > 0) continue;
+
+        McCore *victim = pick_core(sim, false);
+        QHeap *queue = &victim->store.ready_queue;
+        int spare = queue->size / 2;
+        if (spare == 0) break;
+        for (int k = 0; k < spare; k++) {
+            if (!migrate(victim, queue->heap[queue->size - 1], thief)) return false;
+        }
+    }
+    return true;
+}
+
+// One quantum on one core: the Q-table decision, then the run
+static void step_core(McCore *core) {
+    ProcessStore *store = &core->store;
+    update_q_table_incremental(store);
+    int selected = select_action(store);
+    if (selected < 0) return;
+
+    core->decisions++;
+    core->busy++;
+    run_quantum(store, selected, &core->rng);
+    if (store->completed[selected]) {
+        remove_completed_process(store, selected);
+    }
+}
+
+static void step_cores(MultiCoreSim *sim, int first, int stride) {
+    for (int c = first; c < sim->core_count; c += stride) {
+        step_core(&sim->cores[c]);
+    }
+}
+
+// Between quanta: advance the clock, admit arrivals and rebalance
+static bool end_round(MultiCoreSim *sim) {
+    sim->rounds++;
+    sim->time += TIME_QUANTUM;
+    return run_arrivals(sim) && balance(sim);
+}
+
+typedef struct {
+    MultiCoreSim *sim;
+    int threads;
+    bool stop;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    int arrived;    // threads waiting in wait_all()
+    int generation; // completed waits
+} McRun;
+
+typedef struct {
+    McRun *run;
+    int index;
+} McThread;
+
+// Block until every thread of the run has called this
+static void wait_all(McRun *run) {
+    pthread_mutex_lock(&run->lock);
+    int generation = run->generation;
+    if (++run->arrived == run->threads) {
+        run->arrived = 0;
+        run->generation++;
+        pthread_cond_broadcast(&run->cond);
+    } else {
+        while (generation == run->generation) {
+            pthread_cond_wait(&run->cond, &run->lock);
+        }
+    }
+    pthread_mutex_unlock(&run->lock);
+}
+
+// Each quantum: wait for the start, step this thread's cores, wait until
+// every thread has stepped its cores
+static void *mc_worker(void *arg) {
+    McThread *thread = arg;
+    McRun *run = thread->run;
+    for (;;) {
+        wait_all(run);
+        if (run->stop) return NULL;
+        step_cores(run->sim, thread->index, run->threads);
+        wait_all(run);
+    }
+}
+
+// Step the quanta with the calling thread as thread 0 of `threads`. If a
+// thread cannot start, the run goes on with the ones that did.
+static bool run_threaded(MultiCoreSim *sim, int threads) {
+    McRun run = {sim, threads, false, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0};
+    McThread *workers = malloc((size_t)threads * sizeof(McThread));
+    pthread_t *ids = malloc((size_t)threads * sizeof(pthread_t));
+    if (workers == NULL || ids == NULL) {
+        free(workers);
+        free(ids);
+        return false;
+    }
+
+    int started = 1;
+    for (; started < threads; started++) {
+        workers[started] = (McThread){&run, started};
+        if (pthread_create(&ids[started], NULL, mc_worker, &workers[started]) != 0) break;
+    }
+    pthread_mutex_lock(&run.lock);
+    run.threads = started;
+    pthread_mutex_unlock(&run.lock);
+
+    bool ok = true;
+    while (ok && any_ready(sim)) {
+        wait_all(&run);
+        step_cores(sim, 0, run.threads);
+        wait_all(&run);
+        ok = end_round(sim);
+    }
+    run.stop = true;
+    wait_all(&run);
+    for (int t = 1; t < started; t++) {
+        pthread_join(ids[t], NULL);
+    }
+
+    free(workers);
+    free(ids);
+    return ok;
+}
+
+bool mc_run(MultiCoreSim *sim, int threads) {
+    for (int c = 0; c < sim->core_count; c++) {
+        initialize_q_table(&sim->cores[c].store);
+    }
+    if (!run_arrivals(sim) || !balance(sim)) return false;
+
+    if (threads > sim->core_count) threads = sim->core_count;
+    if (threads > 1) return run_threaded(sim, threads);
+
+    while (any_ready(sim)) {
+        step_cores(sim, 0, 1);
+        if (!end_round(sim)) return false;
+    }
+    return true;
+}
+
+double mc_imbalance(const MultiCoreSim *sim) {
+    long total = 0, busiest = 0;
+    for (int c = 0; c < sim->core_count; c++) {
+        total += sim->cores[c].busy;
+        if (sim->cores[c].busy > busiest) busiest = sim->cores[c].busy;
+    }
+    if (total == 0) return 0.0;
+    return (double)busiest * sim->core_count / (double)total - 1.0;
+}
+
+void mc_free(MultiCoreSim *sim) {
+    for (int c = 0; c < sim->core_count; c++) {
+        store_free(&sim->cores[c].store);
+    }
+    free(sim->cores);
+    free(sim->arrivals);
+    timing_wheel_free(&sim->events);
+    memset(sim, 0, sizeof(*sim));
+}
@@ -0,0 +1,82 @@
+#ifndef MULTICORE_H
+#define MULTICORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "process_store.h"
+#include "rng.h"
+#include "timing_wheel.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The Q-table simulation on M cores.
+//
+//   MultiCoreSim sim;
+//   mc_init(&sim, cores);
+//   mc_add_process(&sim, p);         // once per process
+//   mc_run(&sim, threads);
+//   ... sim.cores[c].busy, mc_imbalance(&sim) ...
+//   mc_free(&sim);
+//
+// Every core has its own process store, ready queue and Q-table, and each
+// quantum every core makes its own decision and runs the process it picked;
+// the processes queued on a core but not running there wait. Processes
+// present at the start are dealt out round-robin, and each arrival joins the
+// core with the fewest ready processes. A core left with nothing ready
+// steals half of the ready processes of the core with the most, taken from
+// the tail of its ready queue so the victim keeps the processes it ranks
+// highest; a stolen process keeps its Q row.
+//
+// Within a quantum the cores are independent, so mc_run() can spread them
+// over threads: each thread steps its share of the cores, and between
+// quanta one thread advances the clock, admits arrivals and balances the
+// queues. Each core draws its random state changes from its own stream of
+// the seed, so results do not depend on the number of threads. With one
+// core the run is the same as SimEngine's.
+
+typedef struct {
+    ProcessStore store; // processes queued on, or completed by, this core
+    Rng rng;
+    long busy;          // quanta spent running a process
+    long decisions;
+    long stolen;        // processes taken from other cores
+} McCore;
+
+typedef struct {
+    McCore *cores;
+    int core_count;
+    int next_core;      // where the next process present at the start goes
+    int time;           // simulated clock at the end of the run
+    long rounds;        // quanta simulated
+
+    Process *arrivals;  // processes arriving after time 0, until admitted
+    int arrival_count;
+    int arrival_capacity;
+    int admitted;
+    TimingWheel events; // arrival time -> index into arrivals
+} MultiCoreSim;
+
+bool mc_init(MultiCoreSim *sim, int cores);
+bool mc_add_process(MultiCoreSim *sim, Process p);
+
+// Give core c the c-th jump-ahead stream of `seed`, or of `rng`
+void mc_seed(MultiCoreSim *sim, uint64_t seed);
+void mc_set_rng(MultiCoreSim *sim, const Rng *rng);
+
+// Run every process to completion with up to `threads` threads, one core
+// per thread at most. Returns false with errno set if a store cannot grow.
+bool mc_run(MultiCoreSim *sim, int threads);
+
+// Load imbalance of the busy time: the busiest core's over the mean, minus
+// one. 0 when every core did the same work.
+double mc_imbalance(const MultiCoreSim *sim);
+
+void mc_free(MultiCoreSim *sim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MULTICORE_H
@@ -0,0 +1,190 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "multicore.h"
+#include "q_scheduler.h"
+#include "workload.h"
+
+// Runs one workload through the Q-table scheduler on M cores and reports
+// each core's utilization, the load imbalance, and waiting and turnaround
+// times. The workload is generated from the seed, or read from a CSV or
+// compiled file, and the cores continue on the seed's stream, so with one
+// core the run matches episode 0 of build/bench.
+
+#define MC_THREAD_THRESHOLD 16 // from this many cores on, one thread per core
+
+typedef struct {
+    int cores;
+    int processes;
+    int threads;    // 0: one per core for large core counts, else one
+    uint64_t seed;
+    double arrival_rate;
+    const char *workload_path;
+} MulticoreConfig;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted values
+static double percentile(const double *sorted, int n, double p) {
+    int rank = (int)ceil(p * n);
+    if (rank < 1) rank = 1;
+    return sorted[rank - 1];
+}
+
+static Process *load_workload(const MulticoreConfig *config, Rng *rng, int *count) {
+    Process *workload;
+    if (config->workload_path == NULL) {
+        *count = config->processes;
+        workload = malloc((size_t)*count * sizeof(Process));
+        if (workload == NULL) {
+            perror("Error allocating workload");
+            exit(EXIT_FAILURE);
+        }
+        generate_processes(workload, *count, 0, rng);
+    } else {
+        ProcessStore store;
+        WorkloadStats stats = {0};
+        if (!store_init(&store, 0) || !workload_load(&store, config->workload_path, 0, &stats)) {
+            if (stats.bad_lines == 0) {
+                perror("Error reading workload");
+            }
+            exit(EXIT_FAILURE);
+        }
+        *count = store.count;
+        workload = malloc((size_t)(store.count > 0 ? store.count : 1) * sizeof(Process));
+        if (workload == NULL) {
+            perror("Error allocating workload");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < store.count; i++) {
+            workload[i] = store_get(&store, i);
+        }
+        store_free(&store);
+    }
+
+    if (config->arrival_rate > 0.0) {
+        generate_arrivals(workload, *count, config->arrival_rate, rng);
+    }
+    return workload;
+}
+
+static void report(const MultiCoreSim *sim, int count, double wall, int threads) {
+    double *waiting = malloc((size_t)(count > 0 ? count : 1) * sizeof(double));
+    if (waiting == NULL) {
+        perror("Error allocating results");
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%-6s %10s %12s %10s %8s %10s\n", "Core", "Busy", "Utilization", "Decisions", "Stolen", "Processes");
+    long busy = 0, decisions = 0;
+    int n = 0;
+    for (int c = 0; c < sim->core_count; c++) {
+        const McCore *core = &sim->cores[c];
+        double utilization = sim->time > 0 ? (double)core->busy * TIME_QUANTUM / sim->time : 0.0;
+        printf("%-6d %10ld %11.1f%% %10ld %8ld %10d\n", c, core->busy * TIME_QUANTUM, 100.0 * utilization,
+               core->decisions, core->stolen, core->store.count);
+        busy += core->busy;
+        decisions += core->decisions;
+        for (int i = 0; i < core->store.count; i++) {
+            waiting[n++] = store_waiting_time(&core->store, i);
+        }
+    }
+
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) sum += waiting[i];
+    qsort(waiting, (size_t)n, sizeof(double), compare_doubles);
+    double mean = n > 0 ? sum / n : 0.0;
+
+    // Every process is either running or waiting from its arrival to its
+    // completion, so the turnaround times add up to the waiting times plus
+    // the busy time
+    double turnaround = n > 0 ? (sum + (double)busy * TIME_QUANTUM) / n : 0.0;
+
+    printf("\nMakespan: %d   Mean utilization: %.1f%%   Load imbalance: %.3f\n", sim->time,
+           sim->time > 0 ? 100.0 * busy * TIME_QUANTUM / ((double)sim->time * sim->core_count) : 0.0,
+           mc_imbalance(sim));
+    if (n > 0) {
+        printf("Waiting mean %.2f, p50 %.0f, p99 %.0f   Turnaround mean %.2f\n", mean,
+               percentile(waiting, n, 0.50), percentile(waiting, n, 0.99), turnaround);
+    }
+    printf("%ld decisions in %.3f s on %d thread%s: %.0f decisions/s\n", decisions, wall, threads,
+           threads == 1 ? "" : "s", wall > 0.0 ? decisions / wall : 0.0);
+    free(waiting);
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [--cores M] [--processes N] [--threads N] [--seed N] [--arrival-rate R]\n"
+            "          [--workload FILE]\n",
+            program);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[]) {
+    MulticoreConfig config = {4, 1000, 0, 1, 0.0, NULL};
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) usage(argv[0]);
+        const char *value = argv[++i];
+        if (strcmp(argv[i - 1], "--cores") == 0) config.cores = atoi(value);
+        else if (strcmp(argv[i - 1], "--processes") == 0) config.processes = atoi(value);
+        else if (strcmp(argv[i - 1], "--threads") == 0) config.threads = atoi(value);
+        else if (strcmp(argv[i - 1], "--seed") == 0) config.seed = strtoull(value, NULL, 0);
+        else if (strcmp(argv[i - 1], "--arrival-rate") == 0) config.arrival_rate = atof(value);
+        else if (strcmp(argv[i - 1], "--workload") == 0) config.workload_path = value;
+        else usage(argv[0]);
+    }
+    if (config.cores < 1 || config.processes < 1 || config.threads < 0 || config.arrival_rate < 0.0) {
+        usage(argv[0]);
+    }
+    int threads = config.threads > 0 ? config.threads : config.cores >= MC_THREAD_THRESHOLD ? config.cores : 1;
+    if (threads > config.cores) threads = config.cores;
+
+    Rng rng;
+    rng_seed(&rng, config.seed);
+    int count;
+    Process *workload = load_workload(&config, &rng, &count);
+
+    MultiCoreSim sim;
+    if (!mc_init(&sim, config.cores)) {
+        perror("Error allocating simulation");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < count; i++) {
+        if (!mc_add_process(&sim, workload[i])) {
+            perror("Error adding process");
+            exit(EXIT_FAILURE);
+        }
+    }
+    mc_set_rng(&sim, &rng);
+
+    printf("%d cores x %d processes, %d thread%s, seed %llu", config.cores, count, threads,
+           threads == 1 ? "" : "s", (unsigned long long)config.seed);
+    if (config.arrival_rate > 0.0) printf(", arrival rate %g", config.arrival_rate);
+    printf("\n\n");
+
+    double start = now_seconds();
+    if (!mc_run(&sim, threads)) {
+        perror("Error running simulation");
+        exit(EXIT_FAILURE);
+    }
+    report(&sim, count, now_seconds() - start, threads);
+
+    mc_free(&sim);
+    free(workload);
+    return 0;
+}
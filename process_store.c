@@ -0,0 +1,226 @@
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include "process_store.h"
+
+#define STORE_MIN_CAPACITY 16
+#define Q_TABLE_ALIGNMENT 32
+
+// realloc() a column to `capacity` elements, bailing out of the caller on failure
+#define GROW_COLUMN(column, capacity)                                              \
+    do {                                                                           \
+        void *grown = realloc((column), (size_t)(capacity) * sizeof(*(column)));   \
+        if (grown == NULL) return false;                                           \
+        (column) = grown;                                                          \
+    } while (0)
+
+bool store_init(ProcessStore *store, int initial_capacity) {
+    memset(store, 0, sizeof(*store));
+    if (!qheap_init(&store->ready_queue, 0)) return false;
+
+    if (initial_capacity < STORE_MIN_CAPACITY) {
+        initial_capacity = STORE_MIN_CAPACITY;
+    }
+    return store_reserve(store, initial_capacity);
+}
+
+// Grow the per-process arrays to hold at least `capacity` processes.
+// Existing rows keep their slot; new Q-table rows start at zero.
+bool store_reserve(ProcessStore *store, int capacity) {
+    if (capacity <= store->capacity) return true;
+
+    GROW_COLUMN(store->id, capacity);
+    GROW_COLUMN(store->burst_time, capacity);
+    GROW_COLUMN(store->waiting_time, capacity);
+    GROW_COLUMN(store->enqueued_at, capacity);
+    GROW_COLUMN(store->system_priority, capacity);
+    GROW_COLUMN(store->cpu_utilization, capacity);
+    GROW_COLUMN(store->memory_usage, capacity);
+    GROW_COLUMN(store->completed, capacity);
+    GROW_COLUMN(store->arrival_time, capacity);
+    GROW_COLUMN(store->term_priority_burst, capacity);
+    GROW_COLUMN(store->term_cpu, capacity);
+    GROW_COLUMN(store->term_memory, capacity);
+    GROW_COLUMN(store->dirty, capacity);
+    GROW_COLUMN(store->dirty_list, capacity);
+    GROW_COLUMN(store->active, capacity);
+    GROW_COLUMN(store->active_index, capacity);
+    memset(store->dirty + store->capacity, 0, (size_t)(capacity - store->capacity) * sizeof(bool));
+
+    // realloc() does not keep the vector alignment, so the Q-table is copied
+    size_t row_size = sizeof(*store->q_table);
+    float (*q_table)[Q_ROW_STRIDE] = aligned_alloc(Q_TABLE_ALIGNMENT, (size_t)capacity * row_size);
+    if (q_table == NULL) return false;
+    if (store->capacity > 0) {
+        memcpy(q_table, store->q_table, (size_t)store->capacity * row_size);
+    }
+    memset(q_table + store->capacity, 0, (size_t)(capacity - store->capacity) * row_size);
+    free(store->q_table);
+    store->q_table = q_table;
+
+    if (!qheap_reserve(&store->ready_queue, capacity)) return false;
+
+    store->capacity = capacity;
+    return true;
+}
+
+// Put an incomplete process on the active list
+static void activate(ProcessStore *store, int slot) {
+    store->active_index[slot] = store->active_count;
+    store->active[store->active_count++] = slot;
+}
+
+// Take a process off the active list; the last entry fills its place
+static void deactivate(ProcessStore *store, int slot) {
+    int index = store->active_index[slot];
+    int moved = store->active[--store->active_count];
+    store->active[index] = moved;
+    store->active_index[moved] = index;
+    store->active_index[slot] = -1;
+}
+
+// Append a process and return its slot, or -1 if the store cannot grow.
+int store_add(ProcessStore *store, Process p) {
+    if (store->count == store->capacity) {
+        if (store->capacity > INT_MAX / 2) return -1;
+        if (!store_reserve(store, store->capacity * 2)) return -1;
+    }
+
+    int slot = store->count++;
+    store->id[slot] = p.id;
+    store->burst_time[slot] = p.burst_time;
+    store->waiting_time[slot] = p.waiting_time;
+    store->enqueued_at[slot] = store->clock;
+    store->system_priority[slot] = p.system_priority;
+    store->cpu_utilization[slot] = p.cpu_utilization;
+    store->memory_usage[slot] = p.memory_usage;
+    store->completed[slot] = p.completed;
+    store->arrival_time[slot] = p.arrival_time;
+    store->active_index[slot] = -1;
+    if (!p.completed) activate(store, slot);
+    store_mark_dirty(store, slot);
+    return slot;
+}
+
+// Finish adding the rows [first, count) that a loader wrote straight into
+// the columns: they enter the queue now and their reward terms are built on
+// the next sweep.
+void store_adopt_rows(ProcessStore *store, int first) {
+    for (int slot = first; slot < store->count; slot++) {
+        store->enqueued_at[slot] = store->clock;
+        store->active_index[slot] = -1;
+        if (!store->completed[slot]) activate(store, slot);
+        store_mark_dirty(store, slot);
+    }
+}
+
+// Mark a process completed, taking it off the active list
+void store_complete(ProcessStore *store, int slot) {
+    if (store->completed[slot]) return;
+    store->completed[slot] = true;
+    deactivate(store, slot);
+}
+
+Process store_get(const ProcessStore *store, int slot) {
+    Process p;
+    p.id = store->id[slot];
+    p.burst_time = store->burst_time[slot];
+    p.waiting_time = store_waiting_time(store, slot);
+    p.system_priority = store->system_priority[slot];
+    p.cpu_utilization = store->cpu_utilization[slot];
+    p.memory_usage = store->memory_usage[slot];
+    p.completed = store->completed[slot];
+    p.arrival_time = store->arrival_time[slot];
+    return p;
+}
+
+// Drop `slot` from the dirty list
+static void unlist_dirty(ProcessStore *store, int slot) {
+    for (int d = 0; d < store->dirty_count; d++) {
+        if (store->dirty_list[d] == slot) {
+            store->dirty_list[d] = store->dirty_list[--store->dirty_count];
+            break;
+        }
+    }
+    store->dirty[slot] = false;
+}
+
+// Remove a process. The last process moves into its slot, with its Q row,
+// cached reward terms and place in the ready queue, so slots stay dense;
+// that is the only slot that changes.
+void store_remove(ProcessStore *store, int slot) {
+    int last = --store->count;
+    qheap_remove(&store->ready_queue, slot);
+    if (store->dirty[slot]) unlist_dirty(store, slot);
+    if (store->active_index[slot] >= 0) deactivate(store, slot);
+
+    if (slot != last) {
+        bool queued = qheap_contains(&store->ready_queue, last);
+        float score = store->ready_queue.score[last];
+        bool dirty = store->dirty[last];
+        qheap_remove(&store->ready_queue, last);
+        if (dirty) unlist_dirty(store, last);
+
+        store->id[slot] = store->id[last];
+        store->burst_time[slot] = store->burst_time[last];
+        store->waiting_time[slot] = store->waiting_time[last];
+        store->enqueued_at[slot] = store->enqueued_at[last];
+        store->system_priority[slot] = store->system_priority[last];
+        store->cpu_utilization[slot] = store->cpu_utilization[last];
+        store->memory_usage[slot] = store->memory_usage[last];
+        store->completed[slot] = store->completed[last];
+        store->arrival_time[slot] = store->arrival_time[last];
+        memcpy(store->q_table[slot], store->q_table[last], sizeof(*store->q_table));
+        store->term_priority_burst[slot] = store->term_priority_burst[last];
+        store->term_cpu[slot] = store->term_cpu[last];
+        store->term_memory[slot] = store->term_memory[last];
+        store->active_index[slot] = store->active_index[last];
+        if (store->active_index[slot] >= 0) store->active[store->active_index[slot]] = slot;
+
+        if (dirty) store_mark_dirty(store, slot);
+        if (queued) qheap_update(&store->ready_queue, slot, score);
+    }
+
+    // A process added later starts from a zero Q row, as in a new slot
+    memset(store->q_table[last], 0, sizeof(*store->q_table));
+}
+
+// Record that a process's features changed outside of the waiting time,
+// so its cached reward terms are rebuilt on the next incremental sweep.
+void store_mark_dirty(ProcessStore *store, int slot) {
+    if (store->dirty[slot]) return;
+    store->dirty[slot] = true;
+    store->dirty_list[store->dirty_count++] = slot;
+}
+
+// Fold the time every incomplete process has waited since it was queued
+// into its waiting_time column, so the column can be read as it is.
+void store_settle_waiting(ProcessStore *store) {
+    for (int a = 0; a < store->active_count; a++) {
+        int i = store->active[a];
+        store->waiting_time[i] = store_waiting_time(store, i);
+        store->enqueued_at[i] = store->clock;
+    }
+}
+
+void store_free(ProcessStore *store) {
+    free(store->id);
+    free(store->burst_time);
+    free(store->waiting_time);
+    free(store->enqueued_at);
+    free(store->system_priority);
+    free(store->cpu_utilization);
+    free(store->memory_usage);
+    free(store->completed);
+    free(store->arrival_time);
+    free(store->q_table);
+    qheap_free(&store->ready_queue);
+    free(store->term_priority_burst);
+    free(store->term_cpu);
+    free(store->term_memory);
+    free(store->dirty);
+    free(store->dirty_list);
+    free(store->active);
+    free(store->active_index);
+    memset(store, 0, sizeof(*store));
+}
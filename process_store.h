@@ -0,0 +1,105 @@
+#ifndef PROCESS_STORE_H
+#define PROCESS_STORE_H
+
+#include <stdbool.h>
+#include "q_heap.h"
+
+#define MAX_STATES 5
+#define Q_ROW_STRIDE 8 // Q-table rows are padded to one 32-byte vector
+
+// Process structure, used to add a process to the store or read one back
+typedef struct {
+    int id;
+    int burst_time;
+    int waiting_time;
+    int system_priority;
+    float cpu_utilization;
+    float memory_usage;
+    bool completed;
+    int arrival_time;   // when the process enters the ready queue
+} Process;
+
+// Growable process table with its Q-table.
+// Every field of Process is its own column so the per-quantum loops and the
+// vector kernels in q_kernel.c stream through only the features they use:
+// a sweep reads the cached reward terms, the waiting columns and the Q rows,
+// the features behind the terms are read once per decision, and id,
+// arrival_time and completed are only read for display and bookkeeping.
+// All arrays are contiguous and indexed by the process slot returned from
+// store_add(), so a slot stays valid for the whole run even when the store
+// grows (pointers into the arrays do not, re-read them after store_add()).
+// Only store_remove() renumbers a slot: the last one, moved into the gap.
+// ready_queue ranks the incomplete processes by the sum of their Q row.
+// dirty_list holds the slots whose cached reward terms are stale.
+// active lists the incomplete processes densely, so sweeps skip completed
+// ones without testing them and cost as much as the live processes do.
+//
+// Waiting time is kept lazily against the store's clock, which advances by
+// one quantum per run_quantum(): waiting_time holds what a process had
+// waited when it last entered the queue, at enqueued_at, and every quantum
+// it then spends queued is implied by the clock. Read it through
+// store_waiting_time(), or call store_settle_waiting() before reading the
+// column directly.
+typedef struct {
+    int *id;
+    int *burst_time;
+    int *waiting_time;  // up to enqueued_at for incomplete processes
+    int *enqueued_at;   // clock when the process last entered the queue
+    int *system_priority;
+    float *cpu_utilization;
+    float *memory_usage;
+    bool *completed;
+    int *arrival_time;
+
+    float (*q_table)[Q_ROW_STRIDE]; // 32-byte aligned, columns past MAX_STATES stay zero
+    QHeap ready_queue;
+
+    // Reward terms that only change when a process's own features do.
+    // update_q_table_incremental() caches them per row and adds the
+    // waiting-time term on every sweep.
+    float *term_priority_burst; // w1 * priority + w2 * -burst
+    float *term_cpu;            // w4 * -cpu utilization
+    float *term_memory;         // w5 * memory usage
+    bool *dirty;
+    int *dirty_list;
+    int dirty_count;
+
+    // Slots of the incomplete processes in no particular order, and each
+    // slot's index in the list, -1 once it completes
+    int *active;
+    int *active_index;
+    int active_count;   // processes left to complete
+
+    int clock;          // virtual time: TIME_QUANTUM per quantum run
+
+    int count;
+    int capacity;
+} ProcessStore;
+
+// Waiting time of a slot as of the store's clock
+static inline int store_waiting_time(const ProcessStore *store, int slot) {
+    int waiting = store->waiting_time[slot];
+    if (!store->completed[slot]) waiting += store->clock - store->enqueued_at[slot];
+    return waiting;
+}
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool store_init(ProcessStore *store, int initial_capacity);
+bool store_reserve(ProcessStore *store, int capacity);
+int store_add(ProcessStore *store, Process p);
+Process store_get(const ProcessStore *store, int slot);
+void store_remove(ProcessStore *store, int slot);
+void store_adopt_rows(ProcessStore *store, int first);
+void store_complete(ProcessStore *store, int slot);
+void store_mark_dirty(ProcessStore *store, int slot);
+void store_settle_waiting(ProcessStore *store);
+void store_free(ProcessStore *store);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PROCESS_STORE_H
@@ -0,0 +1,135 @@
+#ifndef Q_FIXED_H
+#define Q_FIXED_H
+
+#ifdef Q_FIXED_NO_STDINT
+// For kernels built with -nostdinc, such as xv6: the compiler's own types
+typedef __INT32_TYPE__ int32_t;
+typedef __INT64_TYPE__ int64_t;
+#else
+#include <stdint.h>
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The Q-table decision in integer arithmetic, for code that cannot use
+// floating point, such as a kernel's timer tick: the reward, the Bellman
+// update of a Q row and the choice of the row with the highest sum.
+//
+// Q values and rewards are signed Q23.8 fixed point in an int32_t. Sixteen
+// fraction bits (Q16.16) would overflow: a row converges to about ten
+// times its reward, which is dominated by W_WAITING times the waiting
+// time, so a process that waited 20000 ticks already has Q values near
+// 40000. Eight fraction bits cover times up to QFIX_MAX_TIME with the
+// resolution float has at those magnitudes. The constants carry more
+// bits (the weights 24, the learning rate and discount factor 30) and
+// every product goes through 64 bits, rounded to nearest once.
+//
+// Everything here is inline and uses only integer types, so it compiles
+// with -mgeneral-regs-only. Rows are plain arrays of QFIX_STATES values;
+// the caller keeps one per process wherever its process table lives.
+
+#define QFIX_FRAC_BITS 8
+#define QFIX_ONE (1 << QFIX_FRAC_BITS)
+#define QFIX_STATES 5
+
+// num / den with `bits` fraction bits, rounded to nearest
+#define QFIX_RATIO(num, den, bits) \
+    ((int64_t)(((((int64_t)(num) << (bits)) * 2) + (den)) / (2 * (int64_t)(den))))
+
+// LEARNING_RATE and DISCOUNT_FACTOR of q_scheduler.h
+#define QFIX_RATE_BITS 30
+#define QFIX_LEARNING_RATE QFIX_RATIO(2, 10, QFIX_RATE_BITS)
+#define QFIX_DISCOUNT_FACTOR QFIX_RATIO(9, 10, QFIX_RATE_BITS)
+
+// The W_* reward weights of q_scheduler.h. CPU and memory usage come in
+// percent, so their weights are per percent.
+#define QFIX_WEIGHT_BITS 24
+#define QFIX_W_PRIORITY QFIX_RATIO(35, 100, QFIX_WEIGHT_BITS)
+#define QFIX_W_BURST QFIX_RATIO(20, 100, QFIX_WEIGHT_BITS)
+#define QFIX_W_WAITING QFIX_RATIO(20, 100, QFIX_WEIGHT_BITS)
+#define QFIX_W_CPU QFIX_RATIO(15, 10000, QFIX_WEIGHT_BITS)
+#define QFIX_W_MEMORY QFIX_RATIO(5, 10000, QFIX_WEIGHT_BITS)
+
+// Longer burst and waiting times count as this long, which keeps Q values
+// within +-2^21 and every product within 64 bits
+#define QFIX_MAX_TIME (1 << 20)
+
+typedef int32_t qfix;
+
+typedef struct {
+    int32_t priority;
+    int32_t burst;
+    int32_t waiting;
+    int32_t cpu_percent;    // 0..100
+    int32_t memory_percent; // 0..100
+} QFixFeatures;
+
+// x / 2^bits rounded to nearest, halves up (>> of a negative is arithmetic
+// on every compiler this builds with)
+static inline int64_t qfix_round_shift(int64_t x, int bits) {
+    return (x + ((int64_t)1 << (bits - 1))) >> bits;
+}
+
+static inline qfix qfix_from_int(int32_t x) {
+    return (qfix)(x * QFIX_ONE);
+}
+
+// calculate_reward()
+static inline qfix qfix_reward(const QFixFeatures *f) {
+    int32_t burst = f->burst < QFIX_MAX_TIME ? f->burst : QFIX_MAX_TIME;
+    int32_t waiting = f->waiting < QFIX_MAX_TIME ? f->waiting : QFIX_MAX_TIME;
+    int64_t sum = QFIX_W_PRIORITY * f->priority - QFIX_W_BURST * burst + QFIX_W_WAITING * waiting -
+                  QFIX_W_CPU * f->cpu_percent + QFIX_W_MEMORY * f->memory_percent;
+    return (qfix)qfix_round_shift(sum, QFIX_WEIGHT_BITS - QFIX_FRAC_BITS);
+}
+
+// Largest of the row and 0, as the float path starts its max from 0
+static inline qfix qfix_row_max(const qfix *row) {
+    qfix max = 0;
+    for (int j = 0; j < QFIX_STATES; j++) {
+        if (row[j] > max) max = row[j];
+    }
+    return max;
+}
+
+// The Bellman update of one row, entry by entry as the float path does it:
+// each entry sees the row max including the entries already updated.
+// Returns the row's new sum, the process's score.
+static inline int64_t qfix_update_row(qfix *row, qfix reward) {
+    qfix max_next_q = qfix_row_max(row);
+    int64_t score = 0;
+    for (int j = 0; j < QFIX_STATES; j++) {
+        qfix old_q = row[j];
+        int64_t target = (int64_t)reward + qfix_round_shift(QFIX_DISCOUNT_FACTOR * max_next_q, QFIX_RATE_BITS);
+        qfix new_q = old_q + (qfix)qfix_round_shift(QFIX_LEARNING_RATE * (target - old_q), QFIX_RATE_BITS);
+        row[j] = new_q;
+        if (new_q > max_next_q) {
+            max_next_q = new_q;
+        } else if (old_q == max_next_q && new_q < old_q) {
+            max_next_q = qfix_row_max(row);
+        }
+        score += new_q;
+    }
+    return score;
+}
+
+// select_action(): of the listed slots, the one with the highest score,
+// the lowest slot on ties; -1 for none
+static inline int qfix_select(const int64_t *scores, const int *slots, int n) {
+    int best = -1;
+    for (int k = 0; k < n; k++) {
+        int slot = slots[k];
+        if (best < 0 || scores[slot] > scores[best] || (scores[slot] == scores[best] && slot < best)) {
+            best = slot;
+        }
+    }
+    return best;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // Q_FIXED_H
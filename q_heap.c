@@ -0,0 +1,135 @@
+#include <stdlib.h>
+#include "q_heap.h"
+
+bool qheap_init(QHeap *h, int capacity) {
+    h->heap = NULL;
+    h->position = NULL;
+    h->score = NULL;
+    h->size = 0;
+    h->capacity = 0;
+    return qheap_reserve(h, capacity);
+}
+
+bool qheap_reserve(QHeap *h, int capacity) {
+    if (capacity <= h->capacity) return true;
+
+    int *heap = realloc(h->heap, (size_t)capacity * sizeof(int));
+    if (heap == NULL) return false;
+    h->heap = heap;
+
+    int *position = realloc(h->position, (size_t)capacity * sizeof(int));
+    if (position == NULL) return false;
+    h->position = position;
+
+    float *score = realloc(h->score, (size_t)capacity * sizeof(float));
+    if (score == NULL) return false;
+    h->score = score;
+
+    for (int i = h->capacity; i < capacity; i++) {
+        h->position[i] = -1;
+        h->score[i] = 0.0f;
+    }
+    h->capacity = capacity;
+    return true;
+}
+
+void qheap_free(QHeap *h) {
+    free(h->heap);
+    free(h->position);
+    free(h->score);
+    h->heap = NULL;
+    h->position = NULL;
+    h->score = NULL;
+    h->size = 0;
+    h->capacity = 0;
+}
+
+// True if slot a should sit above slot b.
+static inline bool ranks_higher(const QHeap *h, int a, int b) {
+    return h->score[a] > h->score[b] || (h->score[a] == h->score[b] && a < b);
+}
+
+static inline void place(QHeap *h, int pos, int slot) {
+    h->heap[pos] = slot;
+    h->position[slot] = pos;
+}
+
+static void sift_up(QHeap *h, int pos) {
+    int slot = h->heap[pos];
+    while (pos > 0) {
+        int parent = (pos - 1) / 2;
+        if (!ranks_higher(h, slot, h->heap[parent])) break;
+        place(h, pos, h->heap[parent]);
+        pos = parent;
+    }
+    place(h, pos, slot);
+}
+
+static void sift_down(QHeap *h, int pos) {
+    int slot = h->heap[pos];
+    for (;;) {
+        int best = 2 * pos + 1;
+        if (best >= h->size) break;
+        if (best + 1 < h->size && ranks_higher(h, h->heap[best + 1], h->heap[best])) {
+            best++;
+        }
+        if (!ranks_higher(h, h->heap[best], slot)) break;
+        place(h, pos, h->heap[best]);
+        pos = best;
+    }
+    place(h, pos, slot);
+}
+
+// Insert the slot, or move it to match its new score if already queued.
+bool qheap_update(QHeap *h, int slot, float score) {
+    if (slot >= h->capacity) {
+        int capacity = h->capacity > 0 ? h->capacity : 16;
+        while (capacity <= slot) capacity *= 2;
+        if (!qheap_reserve(h, capacity)) return false;
+    }
+
+    int pos = h->position[slot];
+    if (pos < 0) {
+        h->score[slot] = score;
+        pos = h->size++;
+        place(h, pos, slot);
+        sift_up(h, pos);
+        return true;
+    }
+
+    float old_score = h->score[slot];
+    h->score[slot] = score;
+    if (score > old_score) {
+        sift_up(h, pos);
+    } else if (score < old_score) {
+        sift_down(h, pos);
+    }
+    return true;
+}
+
+void qheap_remove(QHeap *h, int slot) {
+    if (!qheap_contains(h, slot)) return;
+
+    int pos = h->position[slot];
+    int last = h->heap[--h->size];
+    h->position[slot] = -1;
+    if (pos == h->size) return;
+
+    place(h, pos, last);
+    sift_up(h, pos);
+    sift_down(h, h->position[last]);
+}
+
+bool qheap_contains(const QHeap *h, int slot) {
+    return slot >= 0 && slot < h->capacity && h->position[slot] >= 0;
+}
+
+void qheap_set_score(QHeap *h, int slot, float score) {
+    h->score[slot] = score;
+}
+
+void qheap_rebuild(QHeap *h) {
+    for (int pos = h->size / 2 - 1; pos >= 0; pos--) {
+        sift_down(h, pos);
+    }
+}
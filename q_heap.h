@@ -0,0 +1,43 @@
+#ifndef Q_HEAP_H
+#define Q_HEAP_H
+
+#include <stdbool.h>
+
+// Indexed max-heap of process slots keyed on their cached Q score
+// (the sum of the process's Q-table row).
+// Ties go to the lower slot, matching a linear first-max scan.
+typedef struct {
+    int *heap;      // heap position -> process slot
+    int *position;  // process slot -> heap position, -1 when not queued
+    float *score;   // process slot -> cached Q score
+    int size;
+    int capacity;   // number of slots position/score can index
+} QHeap;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool qheap_init(QHeap *h, int capacity);
+bool qheap_reserve(QHeap *h, int capacity);
+void qheap_free(QHeap *h);
+
+bool qheap_update(QHeap *h, int slot, float score);
+void qheap_remove(QHeap *h, int slot);
+bool qheap_contains(const QHeap *h, int slot);
+
+// Bulk re-keying: change scores of queued slots without moving them, then
+// restore heap order for all of them at once in O(n).
+void qheap_set_score(QHeap *h, int slot, float score);
+void qheap_rebuild(QHeap *h);
+
+// Slot with the highest score, or -1 when the heap is empty.
+static inline int qheap_top(const QHeap *h) {
+    return h->size > 0 ? h->heap[0] : -1;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // Q_HEAP_H
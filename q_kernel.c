@@ -0,0 +1,468 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "q_kernel.h"
+#include "q_scheduler.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define Q_KERNEL_X86 1
+#define SSE_TARGET __attribute__((target("sse2")))
+#define AVX2_TARGET __attribute__((target("avx2")))
+#endif
+
+typedef struct {
+    void (*rewards)(const ProcessStore *store, const int *slots, int n, float *rewards);
+    void (*cached_rewards)(const ProcessStore *store, const int *slots, int n, float *rewards);
+    void (*update_rows)(float (*q_table)[Q_ROW_STRIDE], const int *slots, int n,
+                        const float *rewards, float *scores);
+} QKernelOps;
+
+/* ---------------------------------------------------------------------- */
+/* Scalar path, the reference every vector path has to reproduce          */
+/* ---------------------------------------------------------------------- */
+
+static void rewards_scalar(const ProcessStore *store, const int *slots, int n, float *rewards) {
+    for (int r = 0; r < n; r++) {
+        rewards[r] = calculate_reward(store, slots[r]);
+    }
+}
+
+static void cached_rewards_scalar(const ProcessStore *store, const int *slots, int n, float *rewards) {
+    for (int r = 0; r < n; r++) {
+        int i = slots[r];
+        rewards[r] = store->term_priority_burst[i] +
+                     (W_WAITING * (float)store_waiting_time(store, i)) +
+                     store->term_cpu[i] +
+                     store->term_memory[i];
+    }
+}
+
+// Largest Q value of the row, or 0 if none is positive
+static float row_max_next_q(const float *q_row) {
+    float max_next_q = 0;
+    for (int k = 0; k < MAX_STATES; k++) {
+        if (q_row[k] > max_next_q) {
+            max_next_q = q_row[k];
+        }
+    }
+    return max_next_q;
+}
+
+static void update_rows_scalar(float (*q_table)[Q_ROW_STRIDE], const int *slots, int n,
+                               const float *rewards, float *scores) {
+    for (int r = 0; r < n; r++) {
+        float *q_row = q_table[slots[r]];
+        float reward = rewards[r];
+
+        // Each entry sees the row max including the entries already updated.
+        // Track it as entries change and rescan only when the max shrinks.
+        float max_next_q = row_max_next_q(q_row);
+        for (int j = 0; j < MAX_STATES; j++) {
+            float old_q = q_row[j];
+            float new_q = old_q + LEARNING_RATE * (reward + DISCOUNT_FACTOR * max_next_q - old_q);
+            q_row[j] = new_q;
+            if (new_q > max_next_q) {
+                max_next_q = new_q;
+            } else if (old_q == max_next_q && new_q < old_q) {
+                max_next_q = row_max_next_q(q_row);
+            }
+        }
+
+        float q_value = 0;
+        for (int j = 0; j < MAX_STATES; j++) {
+            q_value += q_row[j];
+        }
+        scores[r] = q_value;
+    }
+}
+
+#ifdef Q_KERNEL_X86
+
+/* ---------------------------------------------------------------------- */
+/* SSE2: 4 processes per instruction                                       */
+/* ---------------------------------------------------------------------- */
+
+// A column's values at 4 slots; SSE2 has no gather, so lane by lane
+SSE_TARGET static inline __m128i gather_int_sse(const int *column, const int *slots) {
+    return _mm_setr_epi32(column[slots[0]], column[slots[1]], column[slots[2]], column[slots[3]]);
+}
+
+SSE_TARGET static inline __m128 gather_float_sse(const float *column, const int *slots) {
+    return _mm_setr_ps(column[slots[0]], column[slots[1]], column[slots[2]], column[slots[3]]);
+}
+
+// store_waiting_time() of 4 incomplete processes: the settled wait plus the
+// clock since they were queued
+SSE_TARGET static inline __m128 gather_waiting_sse(const ProcessStore *store, const int *slots) {
+    __m128i since = _mm_sub_epi32(_mm_set1_epi32(store->clock), gather_int_sse(store->enqueued_at, slots));
+    return _mm_cvtepi32_ps(_mm_add_epi32(gather_int_sse(store->waiting_time, slots), since));
+}
+
+SSE_TARGET static void rewards_sse(const ProcessStore *store, const int *slots, int n, float *rewards) {
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    int r = 0;
+    for (; r + 4 <= n; r += 4) {
+        __m128 priority = _mm_cvtepi32_ps(gather_int_sse(store->system_priority, slots + r));
+        __m128 burst = _mm_cvtepi32_ps(gather_int_sse(store->burst_time, slots + r));
+        __m128 waiting = gather_waiting_sse(store, slots + r);
+        __m128 cpu = gather_float_sse(store->cpu_utilization, slots + r);
+        __m128 memory = gather_float_sse(store->memory_usage, slots + r);
+
+        __m128 reward = _mm_mul_ps(_mm_set1_ps(W_PRIORITY), priority);
+        reward = _mm_add_ps(reward, _mm_mul_ps(_mm_set1_ps(W_BURST), _mm_xor_ps(burst, sign)));
+        reward = _mm_add_ps(reward, _mm_mul_ps(_mm_set1_ps(W_WAITING), waiting));
+        reward = _mm_add_ps(reward, _mm_mul_ps(_mm_set1_ps(W_CPU), _mm_xor_ps(cpu, sign)));
+        reward = _mm_add_ps(reward, _mm_mul_ps(_mm_set1_ps(W_MEMORY), memory));
+        _mm_storeu_ps(rewards + r, reward);
+    }
+    rewards_scalar(store, slots + r, n - r, rewards + r);
+}
+
+SSE_TARGET static void cached_rewards_sse(const ProcessStore *store, const int *slots, int n, float *rewards) {
+    int r = 0;
+    for (; r + 4 <= n; r += 4) {
+        __m128 waiting = gather_waiting_sse(store, slots + r);
+        __m128 reward = gather_float_sse(store->term_priority_burst, slots + r);
+        reward = _mm_add_ps(reward, _mm_mul_ps(_mm_set1_ps(W_WAITING), waiting));
+        reward = _mm_add_ps(reward, gather_float_sse(store->term_cpu, slots + r));
+        reward = _mm_add_ps(reward, gather_float_sse(store->term_memory, slots + r));
+        _mm_storeu_ps(rewards + r, reward);
+    }
+    cached_rewards_scalar(store, slots + r, n - r, rewards + r);
+}
+
+// q + LEARNING_RATE * (reward + DISCOUNT_FACTOR * max_next_q - q), evaluated
+// in double like the scalar expression and rounded back to float
+SSE_TARGET static inline __m128 bellman_sse(__m128 q, __m128 max_next_q, __m128d reward_lo, __m128d reward_hi) {
+    const __m128d alpha = _mm_set1_pd(LEARNING_RATE);
+    const __m128d gamma = _mm_set1_pd(DISCOUNT_FACTOR);
+    __m128d q_lo = _mm_cvtps_pd(q);
+    __m128d q_hi = _mm_cvtps_pd(_mm_movehl_ps(q, q));
+    __m128d max_lo = _mm_cvtps_pd(max_next_q);
+    __m128d max_hi = _mm_cvtps_pd(_mm_movehl_ps(max_next_q, max_next_q));
+
+    __m128d lo = _mm_sub_pd(_mm_add_pd(reward_lo, _mm_mul_pd(gamma, max_lo)), q_lo);
+    __m128d hi = _mm_sub_pd(_mm_add_pd(reward_hi, _mm_mul_pd(gamma, max_hi)), q_hi);
+    lo = _mm_add_pd(q_lo, _mm_mul_pd(alpha, lo));
+    hi = _mm_add_pd(q_hi, _mm_mul_pd(alpha, hi));
+    return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi));
+}
+
+SSE_TARGET static void update_rows_sse(float (*q_table)[Q_ROW_STRIDE], const int *slots, int n,
+                                       const float *rewards, float *scores) {
+    int r = 0;
+    for (; r + 4 <= n; r += 4) {
+        // Transpose 4 rows so that column[j] holds state j of all 4 processes
+        float *row0 = q_table[slots[r]], *row1 = q_table[slots[r + 1]];
+        float *row2 = q_table[slots[r + 2]], *row3 = q_table[slots[r + 3]];
+        __m128 column[Q_ROW_STRIDE];
+        __m128 lo0 = _mm_load_ps(row0), hi0 = _mm_load_ps(row0 + 4);
+        __m128 lo1 = _mm_load_ps(row1), hi1 = _mm_load_ps(row1 + 4);
+        __m128 lo2 = _mm_load_ps(row2), hi2 = _mm_load_ps(row2 + 4);
+        __m128 lo3 = _mm_load_ps(row3), hi3 = _mm_load_ps(row3 + 4);
+        _MM_TRANSPOSE4_PS(lo0, lo1, lo2, lo3);
+        _MM_TRANSPOSE4_PS(hi0, hi1, hi2, hi3);
+        column[0] = lo0; column[1] = lo1; column[2] = lo2; column[3] = lo3;
+        column[4] = hi0; column[5] = hi1; column[6] = hi2; column[7] = hi3;
+
+        __m128 reward = _mm_loadu_ps(rewards + r);
+        __m128d reward_lo = _mm_cvtps_pd(reward);
+        __m128d reward_hi = _mm_cvtps_pd(_mm_movehl_ps(reward, reward));
+
+        // Entry j sees the max of the updated entries before it (prefix)
+        // and of the old entries from j on (suffix[j] covers those after j)
+        __m128 suffix[MAX_STATES];
+        suffix[MAX_STATES - 1] = _mm_setzero_ps();
+        for (int j = MAX_STATES - 1; j > 0; j--) {
+            suffix[j - 1] = _mm_max_ps(column[j], suffix[j]);
+        }
+        __m128 prefix = _mm_setzero_ps();
+        __m128 score = _mm_setzero_ps();
+        for (int j = 0; j < MAX_STATES; j++) {
+            __m128 max_next_q = _mm_max_ps(column[j], _mm_max_ps(prefix, suffix[j]));
+            column[j] = bellman_sse(column[j], max_next_q, reward_lo, reward_hi);
+            prefix = _mm_max_ps(column[j], prefix);
+        }
+        for (int j = 0; j < MAX_STATES; j++) {
+            score = _mm_add_ps(score, column[j]);
+        }
+        _mm_storeu_ps(scores + r, score);
+
+        lo0 = column[0]; lo1 = column[1]; lo2 = column[2]; lo3 = column[3];
+        hi0 = column[4]; hi1 = column[5]; hi2 = column[6]; hi3 = column[7];
+        _MM_TRANSPOSE4_PS(lo0, lo1, lo2, lo3);
+        _MM_TRANSPOSE4_PS(hi0, hi1, hi2, hi3);
+        _mm_store_ps(row0, lo0); _mm_store_ps(row0 + 4, hi0);
+        _mm_store_ps(row1, lo1); _mm_store_ps(row1 + 4, hi1);
+        _mm_store_ps(row2, lo2); _mm_store_ps(row2 + 4, hi2);
+        _mm_store_ps(row3, lo3); _mm_store_ps(row3 + 4, hi3);
+    }
+    update_rows_scalar(q_table, slots + r, n - r, rewards + r, scores + r);
+}
+
+/* ---------------------------------------------------------------------- */
+/* AVX2: 8 processes per instruction                                       */
+/* ---------------------------------------------------------------------- */
+
+AVX2_TARGET static inline __m256 gather_int_avx2(const int *column, __m256i slots) {
+    return _mm256_cvtepi32_ps(_mm256_i32gather_epi32(column, slots, sizeof(int)));
+}
+
+AVX2_TARGET static inline __m256 gather_float_avx2(const float *column, __m256i slots) {
+    return _mm256_i32gather_ps(column, slots, sizeof(float));
+}
+
+AVX2_TARGET static inline __m256 gather_waiting_avx2(const ProcessStore *store, __m256i slots) {
+    __m256i queued = _mm256_i32gather_epi32(store->enqueued_at, slots, sizeof(int));
+    __m256i since = _mm256_sub_epi32(_mm256_set1_epi32(store->clock), queued);
+    return _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_i32gather_epi32(store->waiting_time, slots, sizeof(int)), since));
+}
+
+AVX2_TARGET static void rewards_avx2(const ProcessStore *store, const int *slots, int n, float *rewards) {
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    int r = 0;
+    for (; r + 8 <= n; r += 8) {
+        __m256i index = _mm256_loadu_si256((const __m256i *)(slots + r));
+        __m256 priority = gather_int_avx2(store->system_priority, index);
+        __m256 burst = gather_int_avx2(store->burst_time, index);
+        __m256 waiting = gather_waiting_avx2(store, index);
+        __m256 cpu = gather_float_avx2(store->cpu_utilization, index);
+        __m256 memory = gather_float_avx2(store->memory_usage, index);
+
+        __m256 reward = _mm256_mul_ps(_mm256_set1_ps(W_PRIORITY), priority);
+        reward = _mm256_add_ps(reward, _mm256_mul_ps(_mm256_set1_ps(W_BURST), _mm256_xor_ps(burst, sign)));
+        reward = _mm256_add_ps(reward, _mm256_mul_ps(_mm256_set1_ps(W_WAITING), waiting));
+        reward = _mm256_add_ps(reward, _mm256_mul_ps(_mm256_set1_ps(W_CPU), _mm256_xor_ps(cpu, sign)));
+        reward = _mm256_add_ps(reward, _mm256_mul_ps(_mm256_set1_ps(W_MEMORY), memory));
+        _mm256_storeu_ps(rewards + r, reward);
+    }
+    rewards_scalar(store, slots + r, n - r, rewards + r);
+}
+
+AVX2_TARGET static void cached_rewards_avx2(const ProcessStore *store, const int *slots, int n, float *rewards) {
+    int r = 0;
+    for (; r + 8 <= n; r += 8) {
+        __m256i index = _mm256_loadu_si256((const __m256i *)(slots + r));
+        __m256 waiting = gather_waiting_avx2(store, index);
+        __m256 reward = gather_float_avx2(store->term_priority_burst, index);
+        reward = _mm256_add_ps(reward, _mm256_mul_ps(_mm256_set1_ps(W_WAITING), waiting));
+        reward = _mm256_add_ps(reward, gather_float_avx2(store->term_cpu, index));
+        reward = _mm256_add_ps(reward, gather_float_avx2(store->term_memory, index));
+        _mm256_storeu_ps(rewards + r, reward);
+    }
+    cached_rewards_scalar(store, slots + r, n - r, rewards + r);
+}
+
+AVX2_TARGET static inline void transpose8_avx2(__m256 *v) {
+    __m256 t0 = _mm256_unpacklo_ps(v[0], v[1]);
+    __m256 t1 = _mm256_unpackhi_ps(v[0], v[1]);
+    __m256 t2 = _mm256_unpacklo_ps(v[2], v[3]);
+    __m256 t3 = _mm256_unpackhi_ps(v[2], v[3]);
+    __m256 t4 = _mm256_unpacklo_ps(v[4], v[5]);
+    __m256 t5 = _mm256_unpackhi_ps(v[4], v[5]);
+    __m256 t6 = _mm256_unpacklo_ps(v[6], v[7]);
+    __m256 t7 = _mm256_unpackhi_ps(v[6], v[7]);
+    __m256 u0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+    __m256 u6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+    __m256 u7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+    v[0] = _mm256_permute2f128_ps(u0, u4, 0x20);
+    v[1] = _mm256_permute2f128_ps(u1, u5, 0x20);
+    v[2] = _mm256_permute2f128_ps(u2, u6, 0x20);
+    v[3] = _mm256_permute2f128_ps(u3, u7, 0x20);
+    v[4] = _mm256_permute2f128_ps(u0, u4, 0x31);
+    v[5] = _mm256_permute2f128_ps(u1, u5, 0x31);
+    v[6] = _mm256_permute2f128_ps(u2, u6, 0x31);
+    v[7] = _mm256_permute2f128_ps(u3, u7, 0x31);
+}
+
+// Same double-precision Bellman step as bellman_sse(), 8 lanes wide
+AVX2_TARGET static inline __m256 bellman_avx2(__m256 q, __m256 max_next_q, __m256d reward_lo, __m256d reward_hi) {
+    const __m256d alpha = _mm256_set1_pd(LEARNING_RATE);
+    const __m256d gamma = _mm256_set1_pd(DISCOUNT_FACTOR);
+    __m256d q_lo = _mm256_cvtps_pd(_mm256_castps256_ps128(q));
+    __m256d q_hi = _mm256_cvtps_pd(_mm256_extractf128_ps(q, 1));
+    __m256d max_lo = _mm256_cvtps_pd(_mm256_castps256_ps128(max_next_q));
+    __m256d max_hi = _mm256_cvtps_pd(_mm256_extractf128_ps(max_next_q, 1));
+
+    __m256d lo = _mm256_sub_pd(_mm256_add_pd(reward_lo, _mm256_mul_pd(gamma, max_lo)), q_lo);
+    __m256d hi = _mm256_sub_pd(_mm256_add_pd(reward_hi, _mm256_mul_pd(gamma, max_hi)), q_hi);
+    lo = _mm256_add_pd(q_lo, _mm256_mul_pd(alpha, lo));
+    hi = _mm256_add_pd(q_hi, _mm256_mul_pd(alpha, hi));
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(lo)), _mm256_cvtpd_ps(hi), 1);
+}
+
+AVX2_TARGET static void update_rows_avx2(float (*q_table)[Q_ROW_STRIDE], const int *slots, int n,
+                                         const float *rewards, float *scores) {
+    int r = 0;
+    for (; r + 8 <= n; r += 8) {
+        // Transpose 8 rows so that column[j] holds state j of all 8 processes
+        __m256 column[Q_ROW_STRIDE];
+        for (int k = 0; k < 8; k++) {
+            column[k] = _mm256_load_ps(q_table[slots[r + k]]);
+        }
+        transpose8_avx2(column);
+
+        __m256 reward = _mm256_loadu_ps(rewards + r);
+        __m256d reward_lo = _mm256_cvtps_pd(_mm256_castps256_ps128(reward));
+        __m256d reward_hi = _mm256_cvtps_pd(_mm256_extractf128_ps(reward, 1));
+
+        // Entry j sees the max of the updated entries before it (prefix)
+        // and of the old entries from j on (suffix[j] covers those after j)
+        __m256 suffix[MAX_STATES];
+        suffix[MAX_STATES - 1] = _mm256_setzero_ps();
+        for (int j = MAX_STATES - 1; j > 0; j--) {
+            suffix[j - 1] = _mm256_max_ps(column[j], suffix[j]);
+        }
+        __m256 prefix = _mm256_setzero_ps();
+        __m256 score = _mm256_setzero_ps();
+        for (int j = 0; j < MAX_STATES; j++) {
+            __m256 max_next_q = _mm256_max_ps(column[j], _mm256_max_ps(prefix, suffix[j]));
+            column[j] = bellman_avx2(column[j], max_next_q, reward_lo, reward_hi);
+            prefix = _mm256_max_ps(column[j], prefix);
+        }
+        for (int j = 0; j < MAX_STATES; j++) {
+            score = _mm256_add_ps(score, column[j]);
+        }
+        _mm256_storeu_ps(scores + r, score);
+
+        transpose8_avx2(column);
+        for (int k = 0; k < 8; k++) {
+            _mm256_store_ps(q_table[slots[r + k]], column[k]);
+        }
+    }
+    update_rows_sse(q_table, slots + r, n - r, rewards + r, scores + r);
+}
+
+#endif // Q_KERNEL_X86
+
+/* ---------------------------------------------------------------------- */
+/* Dispatch                                                                */
+/* ---------------------------------------------------------------------- */
+
+static const QKernelOps kernel_ops[] = {
+    [Q_KERNEL_SCALAR] = { rewards_scalar, cached_rewards_scalar, update_rows_scalar },
+#ifdef Q_KERNEL_X86
+    [Q_KERNEL_SSE] = { rewards_sse, cached_rewards_sse, update_rows_sse },
+    [Q_KERNEL_AVX2] = { rewards_avx2, cached_rewards_avx2, update_rows_avx2 },
+#endif
+};
+
+static const char *const kernel_names[] = { "scalar", "sse", "avx2" };
+
+static int active_level = -1;
+static double check_tolerance = -1; // negative: check mode off
+
+const char *q_kernel_name(QKernelLevel level) {
+    return kernel_names[level];
+}
+
+QKernelLevel q_kernel_level(void) {
+    if (active_level >= 0) return (QKernelLevel)active_level;
+
+    int level = Q_KERNEL_SCALAR;
+#ifdef Q_KERNEL_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) level = Q_KERNEL_SSE;
+    if (__builtin_cpu_supports("avx2")) level = Q_KERNEL_AVX2;
+#endif
+
+    const char *forced = getenv("Q_KERNEL");
+    if (forced != NULL) {
+        int requested = -1;
+        for (int l = Q_KERNEL_SCALAR; l <= Q_KERNEL_AVX2; l++) {
+            if (strcmp(forced, kernel_names[l]) == 0) requested = l;
+        }
+        if (requested < 0) {
+            fprintf(stderr, "Unknown Q_KERNEL '%s', using %s\n", forced, kernel_names[level]);
+        } else if (requested > level) {
+            fprintf(stderr, "Q_KERNEL %s is not supported by this CPU, using %s\n", forced, kernel_names[level]);
+        } else {
+            level = requested;
+        }
+    }
+
+    const char *check = getenv("Q_KERNEL_CHECK");
+    if (check != NULL) {
+        check_tolerance = fabs(atof(check));
+    }
+
+    active_level = level;
+    return (QKernelLevel)level;
+}
+
+static void check_values(const char *what, int index, const float *expected, const float *actual, int n) {
+    for (int k = 0; k < n; k++) {
+        bool mismatch = check_tolerance == 0
+                            ? memcmp(&expected[k], &actual[k], sizeof(float)) != 0
+                            : !(fabs((double)expected[k] - (double)actual[k]) <= check_tolerance);
+        if (mismatch) {
+            fprintf(stderr, "Q kernel check failed: %s of process %d is %.9g with %s, %.9g with scalar\n",
+                    what, index, actual[k], kernel_names[active_level], expected[k]);
+            exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void q_kernel_rewards(const ProcessStore *store, const int *slots, int n, float *rewards) {
+    QKernelLevel level = q_kernel_level();
+    kernel_ops[level].rewards(store, slots, n, rewards);
+
+    if (check_tolerance >= 0 && level != Q_KERNEL_SCALAR) {
+        for (int r = 0; r < n; r++) {
+            float expected = calculate_reward(store, slots[r]);
+            check_values("reward", slots[r], &expected, &rewards[r], 1);
+        }
+    }
+}
+
+void q_kernel_cached_rewards(const ProcessStore *store, const int *slots, int n, float *rewards) {
+    QKernelLevel level = q_kernel_level();
+    kernel_ops[level].cached_rewards(store, slots, n, rewards);
+
+    if (check_tolerance >= 0 && level != Q_KERNEL_SCALAR) {
+        float expected[Q_KERNEL_BLOCK];
+        for (int chunk = 0; chunk < n; chunk += Q_KERNEL_BLOCK) {
+            int m = n - chunk < Q_KERNEL_BLOCK ? n - chunk : Q_KERNEL_BLOCK;
+            cached_rewards_scalar(store, slots + chunk, m, expected);
+            for (int r = 0; r < m; r++) {
+                check_values("reward", slots[chunk + r], &expected[r], &rewards[chunk + r], 1);
+            }
+        }
+    }
+}
+
+void q_kernel_update_rows(ProcessStore *store, const int *slots, int n,
+                          const float *rewards, float *scores) {
+    QKernelLevel level = q_kernel_level();
+    if (check_tolerance < 0 || level == Q_KERNEL_SCALAR) {
+        kernel_ops[level].update_rows(store->q_table, slots, n, rewards, scores);
+        return;
+    }
+
+    // The scalar path updates copies of the rows, numbered 0..m-1
+    _Alignas(32) float expected[Q_KERNEL_BLOCK][Q_ROW_STRIDE];
+    float expected_scores[Q_KERNEL_BLOCK];
+    int rows[Q_KERNEL_BLOCK];
+    for (int chunk = 0; chunk < n; chunk += Q_KERNEL_BLOCK) {
+        int m = n - chunk < Q_KERNEL_BLOCK ? n - chunk : Q_KERNEL_BLOCK;
+        for (int r = 0; r < m; r++) {
+            rows[r] = r;
+            memcpy(expected[r], store->q_table[slots[chunk + r]], sizeof(*expected));
+        }
+        update_rows_scalar(expected, rows, m, rewards + chunk, expected_scores);
+        kernel_ops[level].update_rows(store->q_table, slots + chunk, m, rewards + chunk, scores + chunk);
+
+        for (int r = 0; r < m; r++) {
+            int slot = slots[chunk + r];
+            check_values("Q row", slot, expected[r], store->q_table[slot], MAX_STATES);
+            check_values("Q score", slot, &expected_scores[r], &scores[chunk + r], 1);
+        }
+    }
+}
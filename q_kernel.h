@@ -0,0 +1,39 @@
+#ifndef Q_KERNEL_H
+#define Q_KERNEL_H
+
+#include "process_store.h"
+
+// Most slots the callers in q_scheduler.c hand to one kernel call
+#define Q_KERNEL_BLOCK 256
+
+// Vector width of the reward / Bellman kernels.
+// The best level the CPU supports is picked at first use; set the
+// Q_KERNEL environment variable to scalar, sse or avx2 to force a lower one.
+// Every level produces the same bits as the scalar path. Setting
+// Q_KERNEL_CHECK=<tolerance> re-runs the scalar path next to the active one
+// and exits with an error if any Q value differs by more than the tolerance
+// (0 checks for bit-exact results).
+typedef enum {
+    Q_KERNEL_SCALAR,
+    Q_KERNEL_SSE,
+    Q_KERNEL_AVX2
+} QKernelLevel;
+
+QKernelLevel q_kernel_level(void);
+const char *q_kernel_name(QKernelLevel level);
+
+// The kernels work on a list of distinct slots of incomplete processes,
+// usually a stretch of the store's active list, gathering each feature.
+
+// rewards[r] = calculate_reward() of slots[r]
+void q_kernel_rewards(const ProcessStore *store, const int *slots, int n, float *rewards);
+
+// Same rewards built from the cached reward terms plus the waiting-time term
+void q_kernel_cached_rewards(const ProcessStore *store, const int *slots, int n, float *rewards);
+
+// Bellman update of the Q row of slots[r] with rewards[r]; scores[r]
+// receives the row's new sum
+void q_kernel_update_rows(ProcessStore *store, const int *slots, int n,
+                          const float *rewards, float *scores);
+
+#endif // Q_KERNEL_H
@@ -0,0 +1,245 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "checksum.h"
+#include "q_policy.h"
+#include "q_scheduler.h"
+
+#define Q_POLICY_MIN_CAPACITY 256
+
+static const char policy_magic[8] = "QPOLICY";
+
+_Static_assert(sizeof(QPolicyEntry) == 32, "entries are half a cache line");
+_Static_assert(sizeof(QPolicyFileHeader) % 8 == 0, "header has no tail padding");
+
+bool q_policy_init(QPolicy *policy, uint32_t capacity) {
+    memset(policy, 0, sizeof(*policy));
+    uint32_t size = Q_POLICY_MIN_CAPACITY;
+    while (size < capacity && size <= UINT32_MAX / 4) size *= 2;
+
+    policy->entries = calloc(size, sizeof(QPolicyEntry));
+    if (policy->entries == NULL) return false;
+    policy->capacity = size;
+    return true;
+}
+
+static inline uint64_t align_entries(uint64_t offset) {
+    return (offset + Q_POLICY_ENTRY_ALIGNMENT - 1) & ~(uint64_t)(Q_POLICY_ENTRY_ALIGNMENT - 1);
+}
+
+bool q_policy_open(QPolicy *policy, const char *path, bool verify) {
+    memset(policy, 0, sizeof(*policy));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    if ((size_t)st.st_size < sizeof(QPolicyFileHeader)) {
+        close(fd);
+        errno = EINVAL;
+        return false;
+    }
+    // Private and writable: learning copies the pages it changes
+    char *data = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+
+    QPolicyFileHeader header;
+    memcpy(&header, data, sizeof(header));
+    uint64_t entries_size = (uint64_t)header.capacity * sizeof(QPolicyEntry);
+    int error = 0;
+    if (memcmp(header.magic, policy_magic, sizeof(header.magic)) != 0 ||
+        header.version != Q_POLICY_VERSION || header.key_layout != Q_POLICY_KEY_LAYOUT ||
+        header.states != MAX_STATES || header.capacity < Q_POLICY_MIN_CAPACITY ||
+        (header.capacity & (header.capacity - 1)) != 0 || header.count > header.capacity / 2 ||
+        header.entries_offset != align_entries(sizeof(header)) ||
+        header.entries_offset + entries_size > (uint64_t)st.st_size) {
+        error = EINVAL;
+    } else if (header.header_checksum != file_checksum(&header, offsetof(QPolicyFileHeader, header_checksum)) ||
+               (verify && header.entries_checksum != file_checksum(data + header.entries_offset, entries_size))) {
+        error = EBADMSG;
+    }
+    if (error != 0) {
+        munmap(data, (size_t)st.st_size);
+        errno = error;
+        return false;
+    }
+
+    policy->entries = (QPolicyEntry *)(data + header.entries_offset);
+    policy->capacity = header.capacity;
+    policy->count = header.count;
+    policy->map = data;
+    policy->map_size = (size_t)st.st_size;
+    return true;
+}
+
+bool q_policy_save(const QPolicy *policy, const char *path) {
+    QPolicyFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, policy_magic, sizeof(header.magic));
+    header.version = Q_POLICY_VERSION;
+    header.key_layout = Q_POLICY_KEY_LAYOUT;
+    header.states = MAX_STATES;
+    header.capacity = policy->capacity;
+    header.count = policy->count;
+    header.entries_offset = align_entries(sizeof(header));
+    size_t entries_size = (size_t)policy->capacity * sizeof(QPolicyEntry);
+    header.entries_checksum = file_checksum(policy->entries, entries_size);
+    header.header_checksum = file_checksum(&header, offsetof(QPolicyFileHeader, header_checksum));
+
+    size_t length = strlen(path);
+    char *temporary = malloc(length + 5);
+    if (temporary == NULL) return false;
+    memcpy(temporary, path, length);
+    memcpy(temporary + length, ".tmp", 5);
+
+    FILE *file = fopen(temporary, "wb");
+    if (file == NULL) {
+        free(temporary);
+        return false;
+    }
+    static const char padding[Q_POLICY_ENTRY_ALIGNMENT];
+    size_t gap = (size_t)header.entries_offset - sizeof(header);
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (gap == 0 || fwrite(padding, 1, gap, file) == gap) &&
+              fwrite(policy->entries, 1, entries_size, file) == entries_size;
+    if (fclose(file) != 0) ok = false;
+    if (ok && rename(temporary, path) != 0) ok = false;
+    if (!ok) {
+        int error = errno;
+        remove(temporary);
+        errno = error;
+    }
+    free(temporary);
+    return ok;
+}
+
+void q_policy_free(QPolicy *policy) {
+    if (policy->map != NULL) {
+        munmap(policy->map, policy->map_size);
+    } else {
+        free(policy->entries);
+    }
+    memset(policy, 0, sizeof(*policy));
+}
+
+// 0 for 0, else 1 + floor(log2(x)), at most 15
+static inline uint32_t log_bucket(int x) {
+    if (x <= 0) return 0;
+    uint32_t bucket = 32 - (uint32_t)__builtin_clz((unsigned)x);
+    return bucket < 15 ? bucket : 15;
+}
+
+static inline uint32_t tenth_bucket(float x) {
+    int bucket = (int)(x * 10.0f);
+    return bucket < 0 ? 0 : bucket > 9 ? 9 : (uint32_t)bucket;
+}
+
+uint32_t q_policy_state(const ProcessStore *store, int slot) {
+    int priority = store->system_priority[slot];
+    uint32_t key = (uint32_t)(priority < 0 ? 0 : priority > 15 ? 15 : priority);
+    key = key << 4 | log_bucket(store->burst_time[slot]);
+    key = key << 4 | log_bucket(store_waiting_time(store, slot));
+    key = key << 4 | tenth_bucket(store->cpu_utilization[slot]);
+    key = key << 4 | tenth_bucket(store->memory_usage[slot]);
+    return key + 1;
+}
+
+// First entry of the state's probe sequence
+static inline uint32_t home(const QPolicy *policy, uint32_t state) {
+    uint32_t bits = (uint32_t)__builtin_ctz(policy->capacity);
+    return (state * 2654435761u) >> (32 - bits);
+}
+
+// Entry holding the state, or the empty entry where it would go
+static QPolicyEntry *probe(const QPolicy *policy, uint32_t state) {
+    uint32_t mask = policy->capacity - 1;
+    for (uint32_t i = home(policy, state);; i = (i + 1) & mask) {
+        QPolicyEntry *e = &policy->entries[i];
+        if (e->key == state || e->key == 0) return e;
+    }
+}
+
+const QPolicyEntry *q_policy_find(const QPolicy *policy, uint32_t state) {
+    const QPolicyEntry *e = probe(policy, state);
+    return e->key == state ? e : NULL;
+}
+
+// Re-insert every entry into a table twice the size, on the heap
+static bool grow(QPolicy *policy) {
+    if (policy->capacity > UINT32_MAX / 4) {
+        errno = ENOMEM;
+        return false;
+    }
+    QPolicy grown = *policy;
+    grown.capacity = policy->capacity * 2;
+    grown.entries = calloc(grown.capacity, sizeof(QPolicyEntry));
+    if (grown.entries == NULL) return false;
+    grown.map = NULL;
+    grown.map_size = 0;
+
+    for (uint32_t i = 0; i < policy->capacity; i++) {
+        if (policy->entries[i].key != 0) {
+            *probe(&grown, policy->entries[i].key) = policy->entries[i];
+        }
+    }
+    q_policy_free(policy);
+    *policy = grown;
+    return true;
+}
+
+bool q_policy_learn(QPolicy *policy, uint32_t state, const float *q_row) {
+    QPolicyEntry *e = probe(policy, state);
+    if (e->key == 0) {
+        if (policy->count + 1 > policy->capacity / 2) {
+            if (!grow(policy)) return false;
+            e = probe(policy, state);
+        }
+        memset(e, 0, sizeof(*e));
+        e->key = state;
+        memcpy(e->q, q_row, sizeof(e->q));
+        e->visits = 1;
+        policy->count++;
+        return true;
+    }
+
+    for (int j = 0; j < MAX_STATES; j++) {
+        e->q[j] += (float)(LEARNING_RATE * (q_row[j] - e->q[j]));
+    }
+    if (e->visits < UINT32_MAX) e->visits++;
+    return true;
+}
+
+uint32_t q_policy_seed(const QPolicy *policy, ProcessStore *store, int slot) {
+    uint32_t state = q_policy_state(store, slot);
+    const QPolicyEntry *e = q_policy_find(policy, state);
+    if (e != NULL) {
+        memcpy(store->q_table[slot], e->q, sizeof(e->q));
+    }
+    return state;
+}
+
+const char *q_policy_path_from_args(int *argc, char *argv[]) {
+    const char *path = NULL;
+    int kept = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (strncmp(argv[i], "--policy=", 9) == 0) {
+            path = argv[i] + 9;
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    *argc = kept;
+    argv[kept] = NULL;
+    return path;
+}
@@ -0,0 +1,103 @@
+#ifndef Q_POLICY_H
+#define Q_POLICY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "process_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Q rows learned across runs, keyed by a discretized process state.
+//
+// The store's Q-table is indexed by slot and starts from zero every run.
+// A policy keeps what runs learn under a state key built from buckets of
+// the process features:
+//   priority         1..10 as it is
+//   burst, waiting   0, then one bucket per power of two up to 2^14
+//   CPU, memory      tenths
+// A process is filed under the state it was admitted in: an engine with a
+// policy starts the process's Q row from that state's entry, and when
+// learning folds the row into the entry as a running average every time
+// it schedules the process.
+//
+// The table is open addressing with linear probing, a power-of-two number
+// of 32-byte entries, at most half full. A snapshot file holds the table
+// as it is in memory:
+//   QPolicyFileHeader
+//   the entries, from a 64-byte boundary
+// in host byte order, with checksums of the header and of the entries.
+// q_policy_open() maps the file and looks entries up in place, so loading
+// a trained policy takes no parsing; learning on an opened policy writes
+// to private copies of the pages it touches, and only q_policy_save()
+// changes a file.
+
+#define Q_POLICY_VERSION 1
+#define Q_POLICY_KEY_LAYOUT 1 // bucketing of q_policy_state()
+#define Q_POLICY_ENTRY_ALIGNMENT 64
+
+typedef struct {
+    uint32_t key;    // q_policy_state(), 0 for an empty entry
+    uint32_t visits; // rows folded in, saturating
+    float q[MAX_STATES];
+    float reserved;
+} QPolicyEntry;
+
+typedef struct {
+    char magic[8];  // "QPOLICY\0"
+    uint32_t version;
+    uint32_t key_layout;
+    uint32_t states;    // MAX_STATES of the writer
+    uint32_t capacity;  // entries, a power of two
+    uint32_t count;     // occupied entries
+    uint32_t reserved;
+    uint64_t entries_offset;
+    uint64_t entries_checksum;
+    uint64_t header_checksum; // of the bytes before it
+} QPolicyFileHeader;
+
+typedef struct {
+    QPolicyEntry *entries;
+    uint32_t capacity;
+    uint32_t count;
+    void *map;          // the snapshot the entries live in, NULL once they are on the heap
+    size_t map_size;
+} QPolicy;
+
+bool q_policy_init(QPolicy *policy, uint32_t capacity);
+
+// Map a snapshot. With verify the entries' checksum is checked too; the
+// header's always is. Returns false with errno set (EINVAL for a file that
+// is not a snapshot of this version and key layout, EBADMSG for a checksum
+// mismatch).
+bool q_policy_open(QPolicy *policy, const char *path, bool verify);
+
+// Write the policy to `path` through a temporary file renamed over it, so
+// a run that has `path` mapped keeps its view
+bool q_policy_save(const QPolicy *policy, const char *path);
+void q_policy_free(QPolicy *policy);
+
+// State key of a process, never 0
+uint32_t q_policy_state(const ProcessStore *store, int slot);
+
+// Entry of a state, or NULL if the policy has not seen it
+const QPolicyEntry *q_policy_find(const QPolicy *policy, uint32_t state);
+
+// Fold a Q row into its state's entry. Returns false with errno set if the
+// table cannot grow.
+bool q_policy_learn(QPolicy *policy, uint32_t state, const float *q_row);
+
+// Start a slot's Q row from the policy, if it knows the slot's state, and
+// return the state
+uint32_t q_policy_seed(const QPolicy *policy, ProcessStore *store, int slot);
+
+// Take --policy=FILE out of the arguments and return FILE, or NULL
+const char *q_policy_path_from_args(int *argc, char *argv[]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // Q_POLICY_H
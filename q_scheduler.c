@@ -0,0 +1,163 @@
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "q_scheduler.h"
+#include "q_kernel.h"
+
+void initialize_q_table(ProcessStore *store) {
+    memset(store->q_table, 0, (size_t)store->capacity * sizeof(*store->q_table));
+
+    // Every incomplete process starts in the ready queue with a zero score
+    for (int i = 0; i < store->count; i++) {
+        if (store->completed[i]) {
+            qheap_remove(&store->ready_queue, i);
+        } else {
+            qheap_update(&store->ready_queue, i, 0.0f);
+        }
+    }
+}
+
+// Process with the highest Q score, read off the top of the ready queue
+int select_action(const ProcessStore *store) {
+    return qheap_top(&store->ready_queue);
+}
+
+// Store the new Q scores of a kernel block's processes.
+// A sweep re-scores every queued process, so the ready queue is re-ordered
+// once with qheap_rebuild() after the last block.
+static void rescore_block(ProcessStore *store, const int *slots, int n, const float *scores) {
+    for (int r = 0; r < n; r++) {
+        qheap_set_score(&store->ready_queue, slots[r], scores[r]);
+    }
+}
+
+void update_q_table(ProcessStore *store) {
+    float rewards[Q_KERNEL_BLOCK];
+    float scores[Q_KERNEL_BLOCK];
+
+    // Rewards and Bellman updates run a block of active processes at a
+    // time; completed rows are never touched
+    for (int begin = 0; begin < store->active_count; begin += Q_KERNEL_BLOCK) {
+        int n = store->active_count - begin < Q_KERNEL_BLOCK ? store->active_count - begin : Q_KERNEL_BLOCK;
+        const int *slots = store->active + begin;
+        q_kernel_rewards(store, slots, n, rewards);
+        q_kernel_update_rows(store, slots, n, rewards, scores);
+        rescore_block(store, slots, n, scores);
+    }
+    qheap_rebuild(&store->ready_queue);
+}
+
+// Same result as update_q_table(), bit for bit.
+// Between sweeps only the scheduled process gets new features; every other
+// process just waits another quantum. The reward terms that do not depend on
+// waiting time are therefore cached per row and rebuilt only for dirty rows,
+// and each sweep adds the waiting-time term onto them in the same order
+// calculate_reward() sums them.
+void update_q_table_incremental(ProcessStore *store) {
+    for (int d = 0; d < store->dirty_count; d++) {
+        int i = store->dirty_list[d];
+        store->term_priority_burst[i] = (W_PRIORITY * (float)store->system_priority[i]) +
+                                        (W_BURST * -(float)store->burst_time[i]);
+        store->term_cpu[i] = W_CPU * -store->cpu_utilization[i];
+        store->term_memory[i] = W_MEMORY * store->memory_usage[i];
+        store->dirty[i] = false;
+    }
+    store->dirty_count = 0;
+
+    float rewards[Q_KERNEL_BLOCK];
+    float scores[Q_KERNEL_BLOCK];
+    for (int begin = 0; begin < store->active_count; begin += Q_KERNEL_BLOCK) {
+        int n = store->active_count - begin < Q_KERNEL_BLOCK ? store->active_count - begin : Q_KERNEL_BLOCK;
+        const int *slots = store->active + begin;
+        q_kernel_cached_rewards(store, slots, n, rewards);
+        q_kernel_update_rows(store, slots, n, rewards, scores);
+        rescore_block(store, slots, n, scores);
+    }
+    qheap_rebuild(&store->ready_queue);
+}
+
+float calculate_reward(const ProcessStore *store, int process_id) {
+    int i = process_id;
+
+    // Calculate reward
+    float reward = (W_PRIORITY * (float)store->system_priority[i]) +
+                   (W_BURST * -(float)store->burst_time[i]) +
+                   (W_WAITING * (float)store_waiting_time(store, i)) +
+                   (W_CPU * -store->cpu_utilization[i]) +
+                   (W_MEMORY * store->memory_usage[i]);
+
+    return reward;
+}
+
+void update_state(ProcessStore *store, int process_id, Rng *rng) {
+    store->system_priority[process_id] = (int)rng_below(rng, 10) + 1;
+    store->cpu_utilization[process_id] = (float)rng_below(rng, 100) / 100.0;
+    store->memory_usage[process_id] = (float)rng_below(rng, 100) / 100.0;
+    store_mark_dirty(store, process_id);
+}
+
+#define GENERATE_BATCH 256
+
+// Random workload: burst 1-20, priority 1-10, CPU and memory usage in
+// hundredths. Each feature is drawn a batch at a time as its own column.
+void generate_processes(Process *out, int count, int first_id, Rng *rng) {
+    int burst[GENERATE_BATCH], priority[GENERATE_BATCH];
+    float cpu[GENERATE_BATCH], memory[GENERATE_BATCH];
+
+    for (int base = 0; base < count; base += GENERATE_BATCH) {
+        int n = count - base < GENERATE_BATCH ? count - base : GENERATE_BATCH;
+        rng_fill_below(rng, burst, n, 20);
+        rng_fill_below(rng, priority, n, 10);
+        rng_fill_uniform(rng, cpu, n, 100);
+        rng_fill_uniform(rng, memory, n, 100);
+
+        for (int i = 0; i < n; i++) {
+            Process *p = &out[base + i];
+            p->id = first_id + base + i;
+            p->burst_time = burst[i] + 1;
+            p->waiting_time = 0;
+            p->system_priority = priority[i] + 1;
+            p->cpu_utilization = cpu[i];
+            p->memory_usage = memory[i];
+            p->completed = false;
+            p->arrival_time = 0;
+        }
+    }
+}
+
+// Give the processes Poisson arrivals, `rate` per unit of time on
+// average, in order of their index
+void generate_arrivals(Process *processes, int count, double rate, Rng *rng) {
+    double time = 0.0;
+    for (int i = 0; i < count; i++) {
+        time += -log(1.0 - rng_double(rng)) / rate;
+        processes[i].arrival_time = (int)time;
+    }
+}
+
+// Run the selected process for one quantum.
+// The others age by moving the store's clock: the running process settles
+// the wait it has built up and re-enters the queue at the end of the
+// quantum, so only its own row is touched.
+void run_quantum(ProcessStore *store, int process_id, Rng *rng) {
+    store->waiting_time[process_id] = store_waiting_time(store, process_id);
+    store->clock += TIME_QUANTUM;
+    store->enqueued_at[process_id] = store->clock;
+
+    store->burst_time[process_id] -= TIME_QUANTUM;
+    if (store->burst_time[process_id] <= 0) {
+        store->burst_time[process_id] = 0;
+        store_complete(store, process_id);
+    }
+
+    // Random state change for dynamic simulation
+    update_state(store, process_id, rng);
+}
+
+void remove_completed_process(ProcessStore *store, int process_id) {
+    for (int i = 0; i < MAX_STATES; i++) {
+        store->q_table[process_id][i] = 0.0;
+    }
+    qheap_remove(&store->ready_queue, process_id);
+}
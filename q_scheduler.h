@@ -0,0 +1,38 @@
+#ifndef Q_SCHEDULER_H
+#define Q_SCHEDULER_H
+
+#include "process_store.h"
+#include "rng.h"
+
+#define TIME_QUANTUM 2
+#define LEARNING_RATE 0.2
+#define DISCOUNT_FACTOR 0.9
+#define EPSILON 0.1 // Exploration factor
+
+// Optimized reward weights
+#define W_PRIORITY 0.35f // Higher priority number, higher reward
+#define W_BURST 0.2f     // Lower burst time, higher reward
+#define W_WAITING 0.2f   // Higher waiting time, higher reward
+#define W_CPU 0.15f      // Lower CPU utilization, higher reward
+#define W_MEMORY 0.05f   // Higher memory usage, higher reward
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void initialize_q_table(ProcessStore *store);
+int select_action(const ProcessStore *store);
+void update_q_table(ProcessStore *store);
+void update_q_table_incremental(ProcessStore *store);
+float calculate_reward(const ProcessStore *store, int process_id);
+void update_state(ProcessStore *store, int process_id, Rng *rng);
+void run_quantum(ProcessStore *store, int process_id, Rng *rng);
+void generate_processes(Process *out, int count, int first_id, Rng *rng);
+void generate_arrivals(Process *processes, int count, double rate, Rng *rng);
+void remove_completed_process(ProcessStore *store, int process_id);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // Q_SCHEDULER_H
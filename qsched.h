@@ -0,0 +1,182 @@
+#ifndef QSCHED_H
+#define QSCHED_H
+
+#include "q_fixed.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The Q-table scheduler as a freestanding core: no libc, no allocation, no
+// globals. The caller owns the scheduler state and the process table, and
+// drives it from its own run loop or timer interrupt:
+//
+//   QSched s;
+//   QSchedProc procs[NPROC];
+//   qsched_init(&s, procs, NPROC);
+//   qsched_admit(&s, &procs[i], priority, burst, cpu, memory, waited); // new process
+//   int next = qsched_pick_next(&s, procs, NPROC);  // sweep and choose
+//   ... run procs[next] ...
+//   if (qsched_on_tick(&s, &procs[next], ticks)) ... // burst used up
+//   qsched_set_features(&procs[i], priority, cpu, memory); // stats changed
+//   qsched_on_exit(&procs[i]);
+//
+// It schedules exactly as the simulator does. Every pick sweeps the Q row
+// of each runnable process with its reward and picks the highest row sum,
+// the lowest index on ties; the process that ran stays runnable and
+// competes at the next pick. Waiting time is kept the way the process
+// store keeps it, against a clock that moves only while a process runs, so
+// a tick touches only the running process.
+//
+// By default the arithmetic is the integer Q23.8 of q_fixed.h, for kernels
+// that cannot use floating point. With QSCHED_FLOAT defined it is the
+// float arithmetic of q_scheduler.c, operation for operation, and picks
+// the same process as the simulator at every step. qsched_xv6.h adapts the
+// core to xv6's process table.
+
+#define QSCHED_STATES QFIX_STATES
+
+#ifdef QSCHED_FLOAT
+typedef float qsched_value;
+typedef float qsched_score;
+
+// q_scheduler.h's constants, repeated so the core needs none of its includes
+#define QSCHED_LEARNING_RATE 0.2
+#define QSCHED_DISCOUNT_FACTOR 0.9
+#define QSCHED_W_PRIORITY 0.35f
+#define QSCHED_W_BURST 0.2f
+#define QSCHED_W_WAITING 0.2f
+#define QSCHED_W_CPU 0.15f
+#define QSCHED_W_MEMORY 0.05f
+#else
+typedef qfix qsched_value;
+typedef int64_t qsched_score;
+#endif
+
+typedef struct {
+    qsched_value q[QSCHED_STATES];
+    qsched_score score;     // row sum after the last sweep
+    int32_t runnable;       // competes at the next pick
+    int32_t priority;
+    int32_t burst;          // remaining
+    int32_t cpu_percent;    // 0..100
+    int32_t memory_percent; // 0..100
+    int32_t waiting;        // as of enqueued_at
+    int32_t enqueued_at;    // clock when it last joined the queue
+} QSchedProc;
+
+typedef struct {
+    int32_t clock; // ticks run so far
+} QSched;
+
+static inline void qsched_on_exit(QSchedProc *p) {
+    for (int j = 0; j < QSCHED_STATES; j++) p->q[j] = 0;
+    p->score = 0;
+    p->runnable = 0;
+}
+
+static inline void qsched_init(QSched *s, QSchedProc *procs, int nproc) {
+    s->clock = 0;
+    for (int i = 0; i < nproc; i++) qsched_on_exit(&procs[i]);
+}
+
+static inline void qsched_set_features(QSchedProc *p, int32_t priority, int32_t cpu_percent,
+                                       int32_t memory_percent) {
+    p->priority = priority;
+    p->cpu_percent = cpu_percent;
+    p->memory_percent = memory_percent;
+}
+
+// Make a process runnable with a zero Q row. `waited` is the time it has
+// already waited, such as since its arrival.
+static inline void qsched_admit(QSched *s, QSchedProc *p, int32_t priority, int32_t burst,
+                                int32_t cpu_percent, int32_t memory_percent, int32_t waited) {
+    qsched_on_exit(p);
+    qsched_set_features(p, priority, cpu_percent, memory_percent);
+    p->burst = burst;
+    p->waiting = waited;
+    p->enqueued_at = s->clock;
+    p->runnable = 1;
+}
+
+static inline int32_t qsched_waiting(const QSched *s, const QSchedProc *p) {
+    return p->waiting + (s->clock - p->enqueued_at);
+}
+
+// `ticks` of the clock went to p: everyone else waited them, p rejoins the
+// queue at the end. Returns 1 when p's burst is used up.
+static inline int qsched_on_tick(QSched *s, QSchedProc *p, int32_t ticks) {
+    p->waiting = qsched_waiting(s, p);
+    s->clock += ticks;
+    p->enqueued_at = s->clock;
+    p->burst -= ticks;
+    if (p->burst > 0) return 0;
+    p->burst = 0;
+    return 1;
+}
+
+#ifdef QSCHED_FLOAT
+
+// calculate_reward(), with usage in hundredths as the simulator draws it
+static inline float qsched_reward(const QSched *s, const QSchedProc *p) {
+    float cpu = (float)((double)p->cpu_percent / 100.0);
+    float memory = (float)((double)p->memory_percent / 100.0);
+    return (QSCHED_W_PRIORITY * (float)p->priority) + (QSCHED_W_BURST * -(float)p->burst) +
+           (QSCHED_W_WAITING * (float)qsched_waiting(s, p)) + (QSCHED_W_CPU * -cpu) +
+           (QSCHED_W_MEMORY * memory);
+}
+
+static inline float qsched_row_max(const float *row) {
+    float max = 0;
+    for (int j = 0; j < QSCHED_STATES; j++) {
+        if (row[j] > max) max = row[j];
+    }
+    return max;
+}
+
+// The scalar Bellman update of q_kernel.c
+static inline void qsched_sweep(const QSched *s, QSchedProc *p) {
+    float reward = qsched_reward(s, p);
+    float max_next_q = qsched_row_max(p->q);
+    for (int j = 0; j < QSCHED_STATES; j++) {
+        float old_q = p->q[j];
+        float new_q = old_q + QSCHED_LEARNING_RATE * (reward + QSCHED_DISCOUNT_FACTOR * max_next_q - old_q);
+        p->q[j] = new_q;
+        if (new_q > max_next_q) {
+            max_next_q = new_q;
+        } else if (old_q == max_next_q && new_q < old_q) {
+            max_next_q = qsched_row_max(p->q);
+        }
+    }
+    float score = 0;
+    for (int j = 0; j < QSCHED_STATES; j++) score += p->q[j];
+    p->score = score;
+}
+
+#else
+
+static inline void qsched_sweep(const QSched *s, QSchedProc *p) {
+    QFixFeatures f = {p->priority, p->burst, qsched_waiting(s, p), p->cpu_percent, p->memory_percent};
+    p->score = qfix_update_row(p->q, qfix_reward(&f));
+}
+
+#endif
+
+// Sweep every runnable process and return the index of the one to run
+// next, or -1 if none is runnable. One pass over the table, with a fixed
+// amount of work per process.
+static inline int qsched_pick_next(QSched *s, QSchedProc *procs, int nproc) {
+    int best = -1;
+    for (int i = 0; i < nproc; i++) {
+        if (!procs[i].runnable) continue;
+        qsched_sweep(s, &procs[i]);
+        if (best < 0 || procs[i].score > procs[best].score) best = i;
+    }
+    return best;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // QSCHED_H
@@ -0,0 +1,308 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "q_scheduler.h"
+#include "qsched.h"
+#include "sim_engine.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define QSCHED_CHECK_TSC 1
+#endif
+
+// User-space driver of the freestanding core (qsched.h) through its xv6
+// adapter (qsched_xv6.h), on a process table shaped like xv6's.
+//
+// Decisions: seeded episodes run on the simulator, and a proc table
+// follows them the way a kernel would: the process that ran is charged
+// its quantum and gets its new features, arrivals are admitted, and
+// qsched_xv6_pick_next() picks from the table. Built with QSCHED_FLOAT
+// (build/qsched_check_float) every pick and every Q row has to be the
+// simulator's, or the run fails; with the integer core (build/qsched_check)
+// it reports how often the picks agree.
+//
+// Latency: cycles per qsched_xv6_pick_next() on a full table of --nproc
+// RUNNABLE processes (xv6's NPROC is 64), with the picked process charged
+// a quantum and given new features after each pick and a finished one
+// replaced. The work per pick does not depend on the data beyond a
+// bounded rescan of a row, so the p99 is the core's worst case; it reports
+// that, the mean and the tail the machine adds.
+
+// The parts of xv6's proc.h the adapter uses
+enum procstate { UNUSED, EMBRYO, SLEEPING, RUNNABLE, RUNNING, ZOMBIE };
+
+struct proc {
+    enum procstate state;
+    int pid;
+    QSchedProc qsched;
+};
+
+#include "qsched_xv6.h"
+
+#ifdef QSCHED_FLOAT
+#define QSCHED_CHECK_MODE "float"
+#else
+#define QSCHED_CHECK_MODE "integer"
+#endif
+
+typedef struct {
+    int episodes;
+    int processes;
+    uint64_t seed;
+    double arrival_rate;
+    int nproc;
+    long picks;
+} QSchedCheckConfig;
+
+typedef struct {
+    QSched s;
+    struct proc *table; // [store slot]
+    int admitted;
+    long decisions;
+    long agreed;
+    long rows_differ;   // float core: rows not bit for bit the simulator's
+    long mismatches;    // clock or completion out of step with the simulator
+} Mirror;
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+static inline uint64_t ticks_now(void) {
+#ifdef QSCHED_CHECK_TSC
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+#endif
+}
+
+static int percent(float usage) {
+    return (int)lrintf(usage * 100.0f);
+}
+
+static void follow_features(struct proc *p, const ProcessStore *store, int slot) {
+    qsched_set_features(&p->qsched, store->system_priority[slot], percent(store->cpu_utilization[slot]),
+                        percent(store->memory_usage[slot]));
+}
+
+static void compare_rows(Mirror *m, const ProcessStore *store) {
+#ifdef QSCHED_FLOAT
+    for (int k = 0; k < store->active_count; k++) {
+        int slot = store->active[k];
+        const QSchedProc *q = &m->table[slot].qsched;
+        if (memcmp(q->q, store->q_table[slot], sizeof(q->q)) != 0 ||
+            q->score != store->ready_queue.score[slot]) {
+            m->rows_differ++;
+        }
+    }
+#else
+    (void)m;
+    (void)store;
+#endif
+}
+
+// The decision point after a simulator step: replay the step on the table
+// and pick
+static void on_step(const SimEngine *sim, void *user_data) {
+    Mirror *m = user_data;
+    const ProcessStore *store = &sim->store;
+
+    int executed = sim->executed;
+    if (executed >= 0) {
+        struct proc *p = &m->table[executed];
+        int finished = qsched_xv6_tick(&m->s, p, TIME_QUANTUM);
+        follow_features(p, store, executed);
+        if (finished != store->completed[executed]) m->mismatches++;
+        if (finished) {
+            qsched_xv6_exit(p);
+            p->state = ZOMBIE;
+        }
+    }
+    if (m->s.clock != store->clock) m->mismatches++;
+    if (sim->finished) return; // the last frame makes no decision
+
+    for (; m->admitted < store->count; m->admitted++) {
+        int slot = m->admitted;
+        struct proc *p = &m->table[slot];
+        p->pid = store->id[slot];
+        if (store->completed[slot]) {
+            p->state = ZOMBIE;
+            continue;
+        }
+        p->state = RUNNABLE;
+        qsched_admit(&m->s, &p->qsched, store->system_priority[slot], store->burst_time[slot],
+                     percent(store->cpu_utilization[slot]), percent(store->memory_usage[slot]),
+                     store->waiting_time[slot]);
+    }
+
+    struct proc *next = qsched_xv6_pick_next(&m->s, m->table, m->admitted);
+    int chosen = next != 0 ? (int)(next - m->table) : -1;
+    m->decisions++;
+    if (chosen == sim->selected) m->agreed++;
+    compare_rows(m, store);
+}
+
+static bool run_decisions(const QSchedCheckConfig *config) {
+    Mirror m;
+    memset(&m, 0, sizeof(m));
+    Process *workload = malloc((size_t)config->processes * sizeof(Process));
+    m.table = malloc((size_t)config->processes * sizeof(struct proc));
+    if (workload == NULL || m.table == NULL) {
+        perror("Error allocating workload");
+        exit(EXIT_FAILURE);
+    }
+
+    Rng stream;
+    rng_seed(&stream, config->seed);
+    double start = now_seconds();
+    for (int e = 0; e < config->episodes; e++) {
+        Rng rng = stream;
+        rng_jump(&stream);
+        generate_processes(workload, config->processes, 0, &rng);
+        if (config->arrival_rate > 0.0) {
+            generate_arrivals(workload, config->processes, config->arrival_rate, &rng);
+        }
+
+        SimEngine sim;
+        if (!sim_init(&sim, config->processes)) {
+            perror("Error allocating simulation");
+            exit(EXIT_FAILURE);
+        }
+        for (int i = 0; i < config->processes; i++) {
+            sim_add_process(&sim, workload[i]);
+        }
+        sim_set_rng(&sim, &rng);
+        memset(m.table, 0, (size_t)config->processes * sizeof(struct proc));
+        qsched_xv6_init(&m.s, m.table, config->processes);
+        m.admitted = 0;
+        sim_set_step_callback(&sim, on_step, &m);
+        while (sim_step(&sim)) {
+        }
+        sim_free(&sim);
+    }
+
+    printf("Decisions (%s core): %d episodes x %d processes, seed %llu", QSCHED_CHECK_MODE, config->episodes,
+           config->processes, (unsigned long long)config->seed);
+    if (config->arrival_rate > 0.0) printf(", arrival rate %g", config->arrival_rate);
+    printf(", %.1f s\n", now_seconds() - start);
+    printf("  %ld decisions, same process %.4f%%", m.decisions,
+           m.decisions > 0 ? 100.0 * m.agreed / m.decisions : 0.0);
+#ifdef QSCHED_FLOAT
+    printf(", rows differing %ld", m.rows_differ);
+#endif
+    printf(", bookkeeping mismatches %ld\n\n", m.mismatches);
+
+    free(workload);
+    free(m.table);
+    bool ok = m.mismatches == 0;
+#ifdef QSCHED_FLOAT
+    ok = ok && m.agreed == m.decisions && m.rows_differ == 0;
+#endif
+    return ok;
+}
+
+static int compare_ticks(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void admit_random(QSched *s, struct proc *p, int pid, Rng *rng) {
+    p->pid = pid;
+    p->state = RUNNABLE;
+    qsched_admit(s, &p->qsched, (int)rng_below(rng, 10) + 1, (int)rng_below(rng, 20) + 1,
+                 (int)rng_below(rng, 100), (int)rng_below(rng, 100), 0);
+}
+
+static void run_latency(const QSchedCheckConfig *config) {
+    struct proc *table = calloc((size_t)config->nproc, sizeof(struct proc));
+    uint64_t *samples = malloc((size_t)config->picks * sizeof(uint64_t));
+    if (table == NULL || samples == NULL) {
+        perror("Error allocating table");
+        exit(EXIT_FAILURE);
+    }
+    Rng rng;
+    rng_seed(&rng, config->seed);
+    QSched s;
+    qsched_xv6_init(&s, table, config->nproc);
+    int next_pid = 0;
+    for (int i = 0; i < config->nproc; i++) {
+        admit_random(&s, &table[i], next_pid++, &rng);
+    }
+
+    uint64_t total = 0;
+    for (long k = 0; k < config->picks; k++) {
+        uint64_t begin = ticks_now();
+        struct proc *p = qsched_xv6_pick_next(&s, table, config->nproc);
+        samples[k] = ticks_now() - begin;
+        total += samples[k];
+
+        if (qsched_xv6_tick(&s, p, TIME_QUANTUM)) {
+            qsched_xv6_exit(p);
+            admit_random(&s, p, next_pid++, &rng);
+        } else {
+            qsched_set_features(&p->qsched, (int)rng_below(&rng, 10) + 1, (int)rng_below(&rng, 100),
+                                (int)rng_below(&rng, 100));
+        }
+    }
+    qsort(samples, (size_t)config->picks, sizeof(uint64_t), compare_ticks);
+    long p99 = (long)((double)config->picks * 0.99);
+    long p9999 = (long)((double)config->picks * 0.9999);
+
+#ifdef QSCHED_CHECK_TSC
+    const char *unit = "cycles";
+#else
+    const char *unit = "ns";
+#endif
+    printf("Pick latency (%s core): %d RUNNABLE processes, %ld picks\n", QSCHED_CHECK_MODE, config->nproc,
+           config->picks);
+    printf("  %s per pick: mean %.0f, p99 %llu (%.1f per process), p99.99 %llu, max %llu\n", unit,
+           (double)total / config->picks, (unsigned long long)samples[p99], (double)samples[p99] / config->nproc,
+           (unsigned long long)samples[p9999], (unsigned long long)samples[config->picks - 1]);
+    printf("  the tail above p99 is interrupts and preemption of this process, not the core\n");
+    free(samples);
+    free(table);
+}
+
+static void usage(const char *program) {
+    fprintf(stderr,
+            "Usage: %s [--episodes N] [--processes N] [--seed N] [--arrival-rate R] [--nproc N] [--picks N]\n",
+            program);
+    exit(EXIT_FAILURE);
+}
+
+int main(int argc, char *argv[]) {
+    QSchedCheckConfig config = {20, 1000, 1, 0.0, 64, 1000000};
+
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) usage(argv[0]);
+        const char *value = argv[++i];
+        if (strcmp(argv[i - 1], "--episodes") == 0) config.episodes = atoi(value);
+        else if (strcmp(argv[i - 1], "--processes") == 0) config.processes = atoi(value);
+        else if (strcmp(argv[i - 1], "--seed") == 0) config.seed = strtoull(value, NULL, 0);
+        else if (strcmp(argv[i - 1], "--arrival-rate") == 0) config.arrival_rate = atof(value);
+        else if (strcmp(argv[i - 1], "--nproc") == 0) config.nproc = atoi(value);
+        else if (strcmp(argv[i - 1], "--picks") == 0) config.picks = atol(value);
+        else usage(argv[0]);
+    }
+    if (config.episodes < 0 || config.processes < 1 || config.arrival_rate < 0.0 || config.nproc < 1 ||
+        config.picks < 1) {
+        usage(argv[0]);
+    }
+
+    bool ok = config.episodes == 0 || run_decisions(&config);
+    run_latency(&config);
+    if (!ok) {
+        fprintf(stderr, "The core did not follow the simulator\n");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,56 @@
+#ifndef QSCHED_XV6_H
+#define QSCHED_XV6_H
+
+// qsched.h over xv6's process table. Include it after proc.h, with a
+//
+//   QSchedProc qsched;
+//
+// member added to struct proc and the kernel built with Q_FIXED_NO_STDINT
+// (xv6 compiles with -nostdinc). The scheduler state lives next to the
+// table, e.g. in ptable, and every call is made with ptable.lock held:
+//
+//   pinit()              qsched_xv6_init(&ptable.qs, ptable.proc, NPROC)
+//   allocproc()/fork()   qsched_xv6_admit(&ptable.qs, p, priority, burst)
+//   trap(), IRQ_TIMER    qsched_xv6_tick(&ptable.qs, myproc(), 1)
+//   scheduler()          p = qsched_xv6_pick_next(&ptable.qs, ptable.proc, NPROC)
+//                        in place of the round-robin scan
+//   exit()               qsched_xv6_exit(p)
+//
+// xv6 keeps no CPU or memory usage, so a kernel that tracks them reports
+// them with qsched_set_features(&p->qsched, ...); until then they count
+// as 0. A process is runnable when its state is RUNNABLE; yield() marks
+// the running process RUNNABLE before it enters the scheduler, so it
+// competes with the others as in the simulator.
+
+#include "qsched.h"
+
+static inline void qsched_xv6_init(QSched *s, struct proc *table, int nproc) {
+    qsched_init(s, 0, 0);
+    for (struct proc *p = table; p < table + nproc; p++) qsched_on_exit(&p->qsched);
+}
+
+static inline void qsched_xv6_admit(QSched *s, struct proc *p, int priority, int burst) {
+    qsched_admit(s, &p->qsched, priority, burst, 0, 0, 0);
+}
+
+static inline int qsched_xv6_tick(QSched *s, struct proc *p, int ticks) {
+    return qsched_on_tick(s, &p->qsched, ticks);
+}
+
+static inline void qsched_xv6_exit(struct proc *p) {
+    qsched_on_exit(&p->qsched);
+}
+
+// The RUNNABLE process to switch to, or 0 (xv6 has no NULL)
+static inline struct proc *qsched_xv6_pick_next(QSched *s, struct proc *table, int nproc) {
+    struct proc *best = 0;
+    for (struct proc *p = table; p < table + nproc; p++) {
+        p->qsched.runnable = p->state == RUNNABLE;
+        if (!p->qsched.runnable) continue;
+        qsched_sweep(s, &p->qsched);
+        if (best == 0 || p->qsched.score > best->qsched.score) best = p;
+    }
+    return best;
+}
+
+#endif // QSCHED_XV6_H
@@ -0,0 +1,123 @@
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "rng.h"
+
+// Expand a 64-bit seed into the generator state with splitmix64, as the
+// xoshiro authors recommend
+void rng_seed(Rng *rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        uint64_t z = (seed += 0x9e3779b97f4a7c15ull);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        rng->s[i] = z ^ (z >> 31);
+    }
+}
+
+void rng_jump(Rng *rng) {
+    static const uint64_t jump[4] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull,
+                                     0xa9582618e03fc9aaull, 0x39abdc4529b1661cull};
+    uint64_t s[4] = {0, 0, 0, 0};
+
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (jump[i] & (1ull << b)) {
+                for (int k = 0; k < 4; k++) s[k] ^= rng->s[k];
+            }
+            rng_next(rng);
+        }
+    }
+    memcpy(rng->s, s, sizeof(s));
+}
+
+// Lemire's multiply-shift with rejection: exact, and almost never divides
+static inline int word_below(uint32_t word, uint32_t bound, uint32_t threshold, uint32_t *value) {
+    uint64_t m = (uint64_t)word * bound;
+    *value = (uint32_t)(m >> 32);
+    return (uint32_t)m >= threshold;
+}
+
+uint32_t rng_below(Rng *rng, uint32_t bound) {
+    uint32_t threshold = (uint32_t)-bound % bound;
+    uint32_t value;
+    while (!word_below((uint32_t)(rng_next(rng) >> 32), bound, threshold, &value)) {
+    }
+    return value;
+}
+
+// Hands out both 32-bit halves of each draw
+typedef struct {
+    Rng *rng;
+    uint64_t bits;
+    int left;
+} WordSource;
+
+static inline uint32_t next_word(WordSource *src) {
+    if (src->left == 0) {
+        src->bits = rng_next(src->rng);
+        src->left = 2;
+    }
+    uint32_t word = (uint32_t)(src->bits >> 32);
+    src->bits <<= 32;
+    src->left--;
+    return word;
+}
+
+void rng_fill_below(Rng *rng, int *out, int count, uint32_t bound) {
+    uint32_t threshold = (uint32_t)-bound % bound;
+    WordSource src = {rng, 0, 0};
+    for (int i = 0; i < count; i++) {
+        uint32_t value;
+        while (!word_below(next_word(&src), bound, threshold, &value)) {
+        }
+        out[i] = (int)value;
+    }
+}
+
+void rng_fill_uniform(Rng *rng, float *out, int count, uint32_t steps) {
+    uint32_t threshold = (uint32_t)-steps % steps;
+    WordSource src = {rng, 0, 0};
+    for (int i = 0; i < count; i++) {
+        uint32_t value;
+        while (!word_below(next_word(&src), steps, threshold, &value)) {
+        }
+        out[i] = (float)((double)value / steps);
+    }
+}
+
+static bool parse_seed(const char *text, uint64_t *seed) {
+    char *end;
+    unsigned long long value = strtoull(text, &end, 0);
+    if (*text == '\0' || *end != '\0') return false;
+    *seed = value;
+    return true;
+}
+
+uint64_t rng_seed_from_env(uint64_t fallback) {
+    const char *requested = getenv("SIM_SEED");
+    if (requested == NULL) return fallback;
+
+    uint64_t seed;
+    if (parse_seed(requested, &seed)) return seed;
+    fprintf(stderr, "Invalid SIM_SEED '%s', using %llu\n", requested, (unsigned long long)fallback);
+    return fallback;
+}
+
+// Consume --seed=<n> from argv.
+uint64_t rng_seed_from_args(int *argc, char *argv[], uint64_t fallback) {
+    uint64_t seed = fallback;
+    int kept = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (strncmp(argv[i], "--seed=", 7) == 0) {
+            if (!parse_seed(argv[i] + 7, &seed)) {
+                fprintf(stderr, "Invalid seed '%s', using %llu\n", argv[i] + 7, (unsigned long long)seed);
+            }
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    *argc = kept;
+    argv[kept] = NULL;
+    return seed;
+}
@@ -0,0 +1,68 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// xoshiro256** pseudo-random generator with explicit seeds.
+//
+// Every simulation owns its Rng, so runs reproduce from their seed and
+// independent runs can go in parallel. rng_jump() advances a generator by
+// 2^128 draws; handing out a copy and then jumping gives each episode or
+// thread its own non-overlapping stream:
+//
+//   Rng master, streams[n];
+//   rng_seed(&master, seed);
+//   for (int i = 0; i < n; i++) { streams[i] = master; rng_jump(&master); }
+
+typedef struct {
+    uint64_t s[4];
+} Rng;
+
+void rng_seed(Rng *rng, uint64_t seed);
+void rng_jump(Rng *rng);
+
+static inline uint64_t rng_rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static inline uint64_t rng_next(Rng *rng) {
+    uint64_t *s = rng->s;
+    uint64_t result = rng_rotl(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rng_rotl(s[3], 45);
+    return result;
+}
+
+// Uniform double in [0, 1)
+static inline double rng_double(Rng *rng) {
+    return (double)(rng_next(rng) >> 11) * 0x1p-53;
+}
+
+// Uniform integer in [0, bound), bound > 0
+uint32_t rng_below(Rng *rng, uint32_t bound);
+
+// Batch versions for filling feature columns; each 64-bit draw yields two
+// values. rng_fill_uniform() writes k / steps for k uniform in [0, steps),
+// the same grid as (float)(rand() % steps) / steps.
+void rng_fill_below(Rng *rng, int *out, int count, uint32_t bound);
+void rng_fill_uniform(Rng *rng, float *out, int count, uint32_t steps);
+
+// Seed from SIM_SEED, or consume --seed=<n> from argv, like the log level
+uint64_t rng_seed_from_env(uint64_t fallback);
+uint64_t rng_seed_from_args(int *argc, char *argv[], uint64_t fallback);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // RNG_H
@@ -0,0 +1,198 @@
+#include <stdlib.h>
+#include <string.h>
+#include "sim_engine.h"
+#include "q_scheduler.h"
+
+// Event values other than arrivals, which are indexes into sim->arrivals
+enum { SIM_EVENT_QUANTUM_EXPIRY = -1 };
+
+bool sim_init(SimEngine *sim, int initial_capacity) {
+    memset(sim, 0, sizeof(*sim));
+    sim->selected = -1;
+    sim->executed = -1;
+    rng_seed(&sim->rng, 0);
+    timing_wheel_init(&sim->events);
+    return store_init(&sim->store, initial_capacity);
+}
+
+// Add a process to the workload; only allowed before the first step.
+// A process arriving at time 0 goes straight into the store, in the order
+// added; a later one becomes an arrival event.
+bool sim_add_process(SimEngine *sim, Process p) {
+    if (sim->started) return false;
+    if (p.arrival_time <= 0) {
+        return store_add(&sim->store, p) >= 0;
+    }
+
+    if (sim->arrival_count == sim->arrival_capacity) {
+        int capacity = sim->arrival_capacity > 0 ? sim->arrival_capacity * 2 : 16;
+        Process *arrivals = realloc(sim->arrivals, (size_t)capacity * sizeof(Process));
+        if (arrivals == NULL) return false;
+        sim->arrivals = arrivals;
+        sim->arrival_capacity = capacity;
+    }
+    if (!timing_wheel_push(&sim->events, p.arrival_time, sim->arrival_count)) return false;
+    sim->arrivals[sim->arrival_count++] = p;
+    return true;
+}
+
+void sim_set_step_callback(SimEngine *sim, SimStepCallback on_step, void *user_data) {
+    sim->on_step = on_step;
+    sim->user_data = user_data;
+}
+
+void sim_seed(SimEngine *sim, uint64_t seed) {
+    rng_seed(&sim->rng, seed);
+}
+
+void sim_set_rng(SimEngine *sim, const Rng *rng) {
+    sim->rng = *rng;
+}
+
+// Only allowed before the first step
+void sim_set_policy(SimEngine *sim, QPolicy *policy, bool learn) {
+    sim->policy = policy;
+    sim->learn_policy = policy != NULL && learn;
+}
+
+void sim_set_selector(SimEngine *sim, SimSelector selector, void *user_data) {
+    sim->selector = selector;
+    sim->selector_data = user_data;
+}
+
+static bool all_completed(const SimEngine *sim) {
+    return sim->admitted == sim->arrival_count && sim->store.active_count == 0;
+}
+
+// Append an arrived process to the store and the ready queue at the
+// decision point `time`
+static void admit_arrival(SimEngine *sim, int arrival, int time) {
+    ProcessStore *store = &sim->store;
+    Process p = sim->arrivals[arrival];
+    p.waiting_time += time - p.arrival_time;
+    int slot = store_add(store, p); // cannot fail, reserved on the first step
+    if (!p.completed) {
+        qheap_update(&store->ready_queue, slot, 0.0f);
+        if (sim->policy != NULL) sim->admitted_state[slot] = q_policy_seed(sim->policy, store, slot);
+    }
+    sim->admitted++;
+}
+
+// Dispatch the events due by the decision point `until` and move the clock
+// there. With nothing ready after that, the next arrival is the decision
+// point instead.
+static void run_events(SimEngine *sim, int until) {
+    int time, event;
+    for (;;) {
+        if (!timing_wheel_pop_until(&sim->events, until, &time, &event)) {
+            if (sim->store.ready_queue.size > 0 || !timing_wheel_pop(&sim->events, &time, &event)) break;
+            until = time;
+        }
+        if (event != SIM_EVENT_QUANTUM_EXPIRY) {
+            admit_arrival(sim, event, until);
+        }
+    }
+    sim->time = until;
+}
+
+static bool finish_step(SimEngine *sim) {
+    sim->frames++;
+    if (sim->on_step != NULL) {
+        sim->on_step(sim, sim->user_data);
+    }
+    return true;
+}
+
+// Advance to the next decision point. Returns false once the run is over,
+// or if the store, the clock or a learning policy cannot grow.
+bool sim_step(SimEngine *sim) {
+    if (sim->finished) return false;
+    ProcessStore *store = &sim->store;
+
+    if (!sim->started) {
+        if (!store_reserve(store, store->count + sim->arrival_count)) return false;
+        initialize_q_table(store);
+        if (sim->policy != NULL) {
+            free(sim->admitted_state);
+            sim->admitted_state = malloc((size_t)store->capacity * sizeof(uint32_t));
+            if (sim->admitted_state == NULL) return false;
+            for (int a = 0; a < store->active_count; a++) {
+                int slot = store->active[a];
+                sim->admitted_state[slot] = q_policy_seed(sim->policy, store, slot);
+            }
+        }
+        sim->started = true;
+    }
+
+    sim->executed = -1;
+    if (sim->selected >= 0) {
+        int selected_process = sim->selected;
+        if (sim->learn_policy &&
+            !q_policy_learn(sim->policy, sim->admitted_state[selected_process], store->q_table[selected_process])) {
+            return false;
+        }
+
+        // The clock reaches the end of the quantum when its expiry is
+        // dispatched
+        int expiry = sim->time + TIME_QUANTUM;
+        if (!timing_wheel_push(&sim->events, expiry, SIM_EVENT_QUANTUM_EXPIRY)) return false;
+        run_quantum(store, selected_process, &sim->rng);
+        sim->executed = selected_process;
+
+        if (all_completed(sim)) {
+            // The last frame still holds the Q row of the process that
+            // finished last
+            run_events(sim, expiry);
+            sim->finished = true;
+            return finish_step(sim);
+        }
+        if (store->completed[selected_process]) {
+            remove_completed_process(store, selected_process);
+        }
+        run_events(sim, expiry);
+    } else if (all_completed(sim)) {
+        sim->finished = true;
+        return false;
+    } else {
+        run_events(sim, sim->time);
+    }
+
+    if (sim->selector != NULL) {
+        sim->selected = sim->selector(store, sim->selector_data);
+    } else {
+        update_q_table_incremental(store);
+        sim->selected = select_action(store);
+    }
+    return finish_step(sim);
+}
+
+// Copy the current decision point into a frame, in the same form
+// trace_read_frame() returns it.
+bool sim_snapshot(const SimEngine *sim, TraceFrame *out) {
+    const ProcessStore *store = &sim->store;
+    uint32_t count = (uint32_t)store->count;
+
+    if (count > out->row_capacity) {
+        TraceRow *rows = realloc(out->rows, (size_t)count * sizeof(TraceRow));
+        if (rows == NULL) return false;
+        out->rows = rows;
+        out->row_capacity = count;
+    }
+    for (int i = 0; i < store->count; i++) {
+        trace_fill_row(&out->rows[i], store, i);
+    }
+
+    out->iteration = sim->frames > 0 ? (uint32_t)(sim->frames - 1) : 0;
+    out->selected_process = sim->selected;
+    out->flags = sim->finished ? TRACE_FRAME_LAST : 0;
+    out->process_count = count;
+    return true;
+}
+
+void sim_free(SimEngine *sim) {
+    store_free(&sim->store);
+    timing_wheel_free(&sim->events);
+    free(sim->arrivals);
+    free(sim->admitted_state);
+    memset(sim, 0, sizeof(*sim));
+}
@@ -0,0 +1,103 @@
+#ifndef SIM_ENGINE_H
+#define SIM_ENGINE_H
+
+#include <stdbool.h>
+#include "process_store.h"
+#include "q_policy.h"
+#include "rng.h"
+#include "timing_wheel.h"
+#include "trace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The Q-table simulation as a library, driven one step at a time.
+//
+//   SimEngine sim;
+//   sim_init(&sim, n);
+//   sim_add_process(&sim, p);        // once per process
+//   sim_set_step_callback(&sim, on_step, user_data);
+//   while (sim_step(&sim)) { ... sim_snapshot(&sim, &frame) ... }
+//   sim_free(&sim);
+//
+// Between steps the engine sits at a decision point: the Q-table has been
+// updated and `selected` is the process that runs next, which is exactly
+// what one trace frame records. The first step only makes the first
+// decision; every later step runs the selected process for TIME_QUANTUM
+// and then makes the next decision, or finishes the run.
+//
+// The clock is a timing wheel of events. Running a process schedules the
+// expiry of its quantum, and the step dispatches events in time order up
+// to it. Processes with an arrival_time after 0 are arrival events: they
+// are appended to the store at the decision point that follows, so the
+// Q-table and the decisions only ever cover the processes that have
+// arrived. When nothing is ready the clock jumps to the next arrival.
+// Waiting time counts from arrival.
+//
+// Random state changes draw from the engine's own generator, seeded with 0
+// unless sim_seed() or sim_set_rng() picks another seed or stream, so a run
+// is reproducible and separate engines can step in parallel.
+//
+// With a policy (sim_set_policy()) every process starts from the Q row the
+// policy holds for the state it was admitted in instead of zeros, and a
+// learning engine folds the row of each process it schedules back into
+// that state's entry. Engines can share a policy that none of them learns
+// into.
+//
+// A selector (sim_set_selector()) replaces the Q-table as the policy: the
+// engine then skips the Q-table sweep and runs whichever process the
+// selector picks at each decision point.
+
+typedef struct SimEngine SimEngine;
+
+// Called at the end of every step that returned true
+typedef void (*SimStepCallback)(const SimEngine *sim, void *user_data);
+
+// Picks the process to run next in place of the Q-table: one of the
+// store's active processes, or -1 if there are none
+typedef int (*SimSelector)(const ProcessStore *store, void *user_data);
+
+struct SimEngine {
+    ProcessStore store;
+    int selected;      // process that runs next; on the last frame, the one that ran last
+    int executed;      // process run by the last step, -1 if it ran none
+    int frames;        // steps taken so far
+    int time;          // simulated clock at the decision point
+    bool started;
+    bool finished;     // all processes completed, sim_step() returns false
+    Rng rng;
+
+    Process *arrivals; // processes arriving after time 0, until admitted
+    int arrival_count;
+    int arrival_capacity;
+    int admitted;       // arrivals already in the store
+    TimingWheel events; // arrivals (index into arrivals) and quantum expiries
+
+    QPolicy *policy;    // warm start, NULL for none
+    bool learn_policy;
+    uint32_t *admitted_state; // policy state of each slot when it was admitted
+
+    SimSelector selector; // NULL: the Q-table picks
+    void *selector_data;
+
+    SimStepCallback on_step;
+    void *user_data;
+};
+
+bool sim_init(SimEngine *sim, int initial_capacity);
+bool sim_add_process(SimEngine *sim, Process p);
+void sim_set_step_callback(SimEngine *sim, SimStepCallback on_step, void *user_data);
+void sim_seed(SimEngine *sim, uint64_t seed);
+void sim_set_rng(SimEngine *sim, const Rng *rng);
+void sim_set_policy(SimEngine *sim, QPolicy *policy, bool learn);
+void sim_set_selector(SimEngine *sim, SimSelector selector, void *user_data);
+bool sim_step(SimEngine *sim);
+bool sim_snapshot(const SimEngine *sim, TraceFrame *out);
+void sim_free(SimEngine *sim);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_ENGINE_H
@@ -0,0 +1,281 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sim_log.h"
+
+enum {
+    RECORD_TEXT,
+    RECORD_SNAPSHOT,
+    RECORD_TRACE
+};
+
+// Every record starts 8-byte aligned with this header.
+typedef struct {
+    uint32_t kind;
+    uint32_t size;      // payload bytes following the header
+    int32_t count;      // text: length, snapshot/trace: rows
+    int32_t selected;   // trace: process about to run
+    uint32_t flags;     // snapshot: LOG_SHOW_*, trace: last frame
+    uint32_t reserved;
+} RecordHeader;
+
+static const char *level_names[] = {"none", "summary", "step", "full"};
+
+LogLevel log_level_from_env(LogLevel fallback) {
+    const char *requested = getenv("SIM_LOG");
+    if (requested == NULL) return fallback;
+
+    for (int l = LOG_NONE; l <= LOG_FULL; l++) {
+        if (strcmp(requested, level_names[l]) == 0) return (LogLevel)l;
+    }
+    fprintf(stderr, "Unknown SIM_LOG '%s', using %s\n", requested, level_names[fallback]);
+    return fallback;
+}
+
+// Consume -q/--quiet (summary only) and --log=<level> from argv.
+LogLevel log_level_from_args(int *argc, char *argv[], LogLevel fallback) {
+    LogLevel level = fallback;
+    int kept = 1;
+    for (int i = 1; i < *argc; i++) {
+        if (strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--quiet") == 0) {
+            level = LOG_SUMMARY;
+        } else if (strncmp(argv[i], "--log=", 6) == 0) {
+            bool known = false;
+            for (int l = LOG_NONE; l <= LOG_FULL; l++) {
+                if (strcmp(argv[i] + 6, level_names[l]) == 0) {
+                    level = (LogLevel)l;
+                    known = true;
+                }
+            }
+            if (!known) {
+                fprintf(stderr, "Unknown log level '%s', using %s\n", argv[i] + 6, level_names[level]);
+            }
+        } else {
+            argv[kept++] = argv[i];
+        }
+    }
+    *argc = kept;
+    argv[kept] = NULL;
+    return level;
+}
+
+/* ---------------------------------------------------------------------- */
+/* Writer thread                                                           */
+/* ---------------------------------------------------------------------- */
+
+static void print_processes(FILE *out, const TraceRow *rows, int count) {
+    fprintf(out, "\nCurrent Process States:\n");
+    fprintf(out, "ID\tBurst\tWait\tPriority\tCPU%%\tMemory%%\tCompleted\n");
+    for (int i = 0; i < count; i++) {
+        const TraceRow *p = &rows[i];
+        fprintf(out, "%d\t%d\t%d\t%d\t\t%.2f\t%.2f\t%s\n",
+                p->id, p->burst_time, p->waiting_time,
+                p->system_priority, p->cpu_utilization,
+                p->memory_usage, p->completed ? "Yes" : "No");
+    }
+}
+
+static void print_q_table(FILE *out, const TraceRow *rows, int count) {
+    fprintf(out, "\nQ-Table:\n");
+    for (int i = 0; i < count; i++) {
+        fprintf(out, "Process %d: ", i);
+        for (int j = 0; j < MAX_STATES; j++) {
+            fprintf(out, "%.2f ", rows[i].q[j]);
+        }
+        fprintf(out, "\n");
+    }
+}
+
+static void drain(SimLog *log, const LogBuffer *buffer) {
+    size_t offset = 0;
+    while (offset < buffer->size) {
+        const RecordHeader *record = (const RecordHeader *)(buffer->data + offset);
+        const void *payload = record + 1;
+
+        switch (record->kind) {
+        case RECORD_TEXT:
+            fwrite(payload, 1, (size_t)record->count, log->out);
+            break;
+        case RECORD_SNAPSHOT:
+            if (record->flags & LOG_SHOW_PROCESSES) print_processes(log->out, payload, record->count);
+            if (record->flags & LOG_SHOW_Q_TABLE) print_q_table(log->out, payload, record->count);
+            break;
+        case RECORD_TRACE:
+            if (!log->failed &&
+                !trace_write_rows(log->trace, payload, record->count, record->selected, record->flags != 0)) {
+                log->failed = true;
+            }
+            break;
+        }
+        offset += sizeof(*record) + ((record->size + 7) & ~(size_t)7);
+    }
+}
+
+static void *writer_main(void *arg) {
+    SimLog *log = arg;
+
+    pthread_mutex_lock(&log->lock);
+    for (;;) {
+        while (!log->back_ready && !log->stop) {
+            pthread_cond_wait(&log->cond, &log->lock);
+        }
+        if (!log->back_ready) break;
+        pthread_mutex_unlock(&log->lock);
+
+        drain(log, log->back);
+        fflush(log->out);
+
+        pthread_mutex_lock(&log->lock);
+        log->back->size = 0;
+        log->back_ready = false;
+        pthread_cond_broadcast(&log->cond);
+    }
+    pthread_mutex_unlock(&log->lock);
+    return NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+/* Simulation side                                                         */
+/* ---------------------------------------------------------------------- */
+
+// Hand the front buffer to the writer. Waits for the writer only when
+// wait is set or the front buffer has reached LOG_MAX_BYTES.
+static void hand_off(SimLog *log, bool wait) {
+    pthread_mutex_lock(&log->lock);
+    if (log->back_ready && (wait || log->front->size >= LOG_MAX_BYTES)) {
+        while (log->back_ready) {
+            pthread_cond_wait(&log->cond, &log->lock);
+        }
+    }
+    if (!log->back_ready) {
+        LogBuffer *filled = log->front;
+        log->front = log->back;
+        log->back = filled;
+        log->back_ready = true;
+        pthread_cond_broadcast(&log->cond);
+    }
+    pthread_mutex_unlock(&log->lock);
+}
+
+// Reserve room for a record in the front buffer and return its payload.
+static void *append_record(SimLog *log, uint32_t kind, size_t size) {
+    LogBuffer *buffer = log->front;
+    size_t needed = sizeof(RecordHeader) + ((size + 7) & ~(size_t)7);
+
+    if (buffer->size + needed > buffer->capacity) {
+        size_t capacity = buffer->capacity > 0 ? buffer->capacity : LOG_FLUSH_BYTES;
+        while (capacity < buffer->size + needed) capacity *= 2;
+        unsigned char *data = realloc(buffer->data, capacity);
+        if (data == NULL) {
+            perror("Error growing log buffer");
+            exit(EXIT_FAILURE);
+        }
+        buffer->data = data;
+        buffer->capacity = capacity;
+    }
+
+    RecordHeader *record = (RecordHeader *)(buffer->data + buffer->size);
+    memset(record, 0, sizeof(*record));
+    record->kind = kind;
+    record->size = (uint32_t)size;
+    buffer->size += needed;
+    return record + 1;
+}
+
+static void after_append(SimLog *log) {
+    if (log->front->size >= LOG_FLUSH_BYTES) {
+        hand_off(log, false);
+    }
+}
+
+bool log_start(SimLog *log, LogLevel level, FILE *out, TraceWriter *trace) {
+    memset(log, 0, sizeof(*log));
+    log->level = level;
+    log->out = out;
+    log->trace = trace;
+    log->front = &log->buffers[0];
+    log->back = &log->buffers[1];
+
+    if (pthread_mutex_init(&log->lock, NULL) != 0) return false;
+    if (pthread_cond_init(&log->cond, NULL) != 0) {
+        pthread_mutex_destroy(&log->lock);
+        return false;
+    }
+    if (pthread_create(&log->thread, NULL, writer_main, log) != 0) {
+        pthread_cond_destroy(&log->cond);
+        pthread_mutex_destroy(&log->lock);
+        return false;
+    }
+    return true;
+}
+
+// Write everything still queued and stop the writer thread.
+// Returns false if a trace frame could not be written.
+bool log_stop(SimLog *log) {
+    if (log->front->size > 0) {
+        hand_off(log, true);
+    }
+
+    pthread_mutex_lock(&log->lock);
+    log->stop = true;
+    pthread_cond_broadcast(&log->cond);
+    pthread_mutex_unlock(&log->lock);
+    pthread_join(log->thread, NULL);
+
+    pthread_cond_destroy(&log->cond);
+    pthread_mutex_destroy(&log->lock);
+    free(log->buffers[0].data);
+    free(log->buffers[1].data);
+    fflush(log->out);
+    return !log->failed;
+}
+
+void log_printf(SimLog *log, LogLevel level, const char *format, ...) {
+    if (!log_enabled(log, level)) return;
+
+    va_list args;
+    va_start(args, format);
+    int length = vsnprintf(NULL, 0, format, args);
+    va_end(args);
+    if (length <= 0) return;
+
+    char *text = append_record(log, RECORD_TEXT, (size_t)length + 1);
+    va_start(args, format);
+    vsnprintf(text, (size_t)length + 1, format, args);
+    va_end(args);
+    ((RecordHeader *)text - 1)->count = length;
+
+    after_append(log);
+}
+
+static TraceRow *snapshot(SimLog *log, uint32_t kind, const ProcessStore *store) {
+    TraceRow *rows = append_record(log, kind, (size_t)store->count * sizeof(TraceRow));
+    ((RecordHeader *)rows - 1)->count = store->count;
+    for (int i = 0; i < store->count; i++) {
+        trace_fill_row(&rows[i], store, i);
+    }
+    return rows;
+}
+
+// Queue a copy of the process table; show picks what gets printed.
+void log_processes(SimLog *log, LogLevel level, const ProcessStore *store, int show) {
+    if (!log_enabled(log, level)) return;
+
+    TraceRow *rows = snapshot(log, RECORD_SNAPSHOT, store);
+    ((RecordHeader *)rows - 1)->flags = (uint32_t)show;
+    after_append(log);
+}
+
+// Queue a trace frame, written by the writer thread like trace_write_frame().
+void log_trace_frame(SimLog *log, const ProcessStore *store, int selected_process, bool last) {
+    if (log->trace == NULL) return;
+
+    TraceRow *rows = snapshot(log, RECORD_TRACE, store);
+    RecordHeader *record = (RecordHeader *)rows - 1;
+    record->selected = selected_process;
+    record->flags = last;
+    after_append(log);
+}
@@ -0,0 +1,83 @@
+#ifndef SIM_LOG_H
+#define SIM_LOG_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <pthread.h>
+#include "process_store.h"
+#include "trace.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Simulation output, written by a background thread.
+//
+// The simulation appends records (formatted text, or a snapshot of the
+// process table copied column by column) to a front buffer without any
+// system call. Once the front buffer holds LOG_FLUSH_BYTES it is swapped
+// with the back buffer and the writer thread formats and writes it while
+// the simulation fills the other one. The simulation only waits when the
+// writer is more than LOG_MAX_BYTES behind.
+//
+// Trace frames go through the same queue, so neither stdout nor the trace
+// file is written from the scheduling loop.
+
+typedef enum {
+    LOG_NONE,     // nothing on stdout
+    LOG_SUMMARY,  // final metrics only
+    LOG_STEP,     // one line per scheduling decision
+    LOG_FULL      // process table after every quantum (default)
+} LogLevel;
+
+#define LOG_FLUSH_BYTES (64 * 1024)
+#define LOG_MAX_BYTES (16 * 1024 * 1024)
+
+// What the writer thread does with a snapshot
+#define LOG_SHOW_PROCESSES 0x1 // print the process table
+#define LOG_SHOW_Q_TABLE 0x2   // print the Q-table
+
+typedef struct {
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+} LogBuffer;
+
+typedef struct {
+    LogLevel level;
+    FILE *out;
+    TraceWriter *trace;   // optional, owned by the caller
+
+    LogBuffer buffers[2];
+    LogBuffer *front;     // filled by the simulation
+    LogBuffer *back;      // drained by the writer thread
+    bool back_ready;      // back holds records not yet written
+    bool stop;
+    bool failed;          // a trace frame could not be written
+
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} SimLog;
+
+LogLevel log_level_from_env(LogLevel fallback);
+LogLevel log_level_from_args(int *argc, char *argv[], LogLevel fallback);
+
+bool log_start(SimLog *log, LogLevel level, FILE *out, TraceWriter *trace);
+bool log_stop(SimLog *log);
+
+static inline bool log_enabled(const SimLog *log, LogLevel level) {
+    return level != LOG_NONE && log->level >= level;
+}
+
+void log_printf(SimLog *log, LogLevel level, const char *format, ...)
+    __attribute__((format(printf, 3, 4)));
+void log_processes(SimLog *log, LogLevel level, const ProcessStore *store, int show);
+void log_trace_frame(SimLog *log, const ProcessStore *store, int selected_process, bool last);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // SIM_LOG_H
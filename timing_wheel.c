@@ -0,0 +1,139 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "timing_wheel.h"
+
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+
+void timing_wheel_init(TimingWheel *w) {
+    memset(w, 0, sizeof(*w));
+}
+
+void timing_wheel_free(TimingWheel *w) {
+    for (int level = 0; level < WHEEL_LEVELS; level++) {
+        for (int slot = 0; slot < WHEEL_SLOTS; slot++) {
+            free(w->slots[level][slot].events);
+        }
+    }
+    memset(w, 0, sizeof(*w));
+}
+
+// Level of the highest byte in which `time` differs from the clock
+static inline int level_of(const TimingWheel *w, int time) {
+    unsigned diff = (unsigned)time ^ (unsigned)w->now;
+    return diff < (1u << 8) ? 0 : diff < (1u << 16) ? 1 : diff < (1u << 24) ? 2 : 3;
+}
+
+static inline int slot_of(int time, int level) {
+    return (int)((unsigned)time >> (level * WHEEL_SLOT_BITS)) & WHEEL_MASK;
+}
+
+// Make room for `extra` more events in a slot
+static bool grow_slot(WheelSlot *s, int extra) {
+    if (s->count + extra <= s->capacity) return true;
+    if (extra > INT_MAX / 2 - s->count) return false;
+
+    int capacity = s->capacity > 0 ? s->capacity : 8;
+    while (capacity < s->count + extra) capacity *= 2;
+    WheelEvent *events = realloc(s->events, (size_t)capacity * sizeof(WheelEvent));
+    if (events == NULL) return false;
+    s->events = events;
+    s->capacity = capacity;
+    return true;
+}
+
+// Append an event to its slot, which has room
+static void file_event(TimingWheel *w, WheelEvent event, int level) {
+    int slot = slot_of(event.time, level);
+    WheelSlot *s = &w->slots[level][slot];
+    if (s->count == 0) {
+        w->occupied[level][slot / 64] |= 1ull << (slot % 64);
+    }
+    s->events[s->count++] = event;
+}
+
+bool timing_wheel_push(TimingWheel *w, int time, int value) {
+    WheelEvent event = {time > w->now ? time : w->now, value};
+    int level = level_of(w, event.time);
+    if (!grow_slot(&w->slots[level][slot_of(event.time, level)], 1)) return false;
+    file_event(w, event, level);
+    w->size++;
+    return true;
+}
+
+// First occupied slot of a level, or -1
+static int first_slot(const TimingWheel *w, int level) {
+    for (int word = 0; word < WHEEL_SLOTS / 64; word++) {
+        uint64_t bits = w->occupied[level][word];
+        if (bits != 0) return word * 64 + __builtin_ctzll(bits);
+    }
+    return -1;
+}
+
+static void empty_slot(TimingWheel *w, int level, int slot) {
+    w->slots[level][slot].first = 0;
+    w->slots[level][slot].count = 0;
+    w->occupied[level][slot / 64] &= ~(1ull << (slot % 64));
+}
+
+// Move the clock to `start` and file the slot's events again on the lower
+// levels. Room is made in every slot they go to first, so running out of
+// memory leaves the wheel as it was.
+static bool cascade(TimingWheel *w, int level, int slot, int start) {
+    WheelSlot *s = &w->slots[level][slot];
+    int old_now = w->now;
+    int needed[WHEEL_LEVELS - 1][WHEEL_SLOTS];
+
+    w->now = start;
+    memset(needed, 0, (size_t)level * sizeof(needed[0]));
+    for (int i = s->first; i < s->count; i++) {
+        int time = s->events[i].time;
+        int lower = level_of(w, time);
+        needed[lower][slot_of(time, lower)]++;
+    }
+    for (int lower = 0; lower < level; lower++) {
+        for (int target = 0; target < WHEEL_SLOTS; target++) {
+            if (needed[lower][target] > 0 && !grow_slot(&w->slots[lower][target], needed[lower][target])) {
+                w->now = old_now;
+                errno = ENOMEM;
+                return false;
+            }
+        }
+    }
+
+    for (int i = s->first; i < s->count; i++) {
+        file_event(w, s->events[i], level_of(w, s->events[i].time));
+    }
+    empty_slot(w, level, slot);
+    return true;
+}
+
+bool timing_wheel_pop_until(TimingWheel *w, int limit, int *time, int *value) {
+    while (w->size > 0) {
+        int slot = first_slot(w, 0);
+        if (slot >= 0) {
+            // Level 0 holds the current block, one tick per slot
+            int due = (w->now & ~WHEEL_MASK) | slot;
+            if (due > limit) return false;
+
+            WheelSlot *s = &w->slots[0][slot];
+            *time = due;
+            *value = s->events[s->first++].value;
+            if (s->first == s->count) empty_slot(w, 0, slot);
+            w->now = due;
+            w->size--;
+            return true;
+        }
+
+        // Level 0 is empty: cascade the earliest slot of the lowest
+        // occupied level, whose start no pending event precedes
+        int level = 1;
+        while ((slot = first_slot(w, level)) < 0) level++;
+        int shift = level * WHEEL_SLOT_BITS;
+        unsigned span = (1u << shift) * WHEEL_SLOTS; // wraps to 0 on the top level
+        int start = (int)(((unsigned)w->now & ~(span - 1)) | ((unsigned)slot << shift));
+        if (start > limit) return false;
+        if (!cascade(w, level, slot, start)) return false;
+    }
+    return false;
+}
@@ -0,0 +1,76 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hierarchical timing wheel of timed events, the simulation clock.
+//
+// Four levels of 256 slots cover every non-negative int time. An event is
+// filed under the highest byte in which its time differs from the wheel's
+// current time: that byte picks the level, and the event's value of it the
+// slot, so a push is O(1). Level 0 holds the events of the current 256-tick
+// block, one slot per tick. Once it is empty, the first occupied slot of the
+// lowest occupied level is cascaded: the clock moves to the start of that
+// slot and its events are filed again, now on lower levels. An event
+// cascades at most three times, so a pop is O(1) amortized. A bitmap per
+// level finds the next occupied slot without visiting empty ones.
+//
+// Each slot keeps its events in an array rather than a linked list, so
+// cascading and popping walk memory in order; slots keep their arrays when
+// they empty, and the wheel stops allocating once it has seen its peak load.
+//
+// Events due at the same time come out in the order they were pushed. The
+// clock only moves forward; an event pushed for an earlier time is due now.
+
+#define WHEEL_LEVELS 4
+#define WHEEL_SLOT_BITS 8
+#define WHEEL_SLOTS (1 << WHEEL_SLOT_BITS)
+
+typedef struct {
+    int time;
+    int value;
+} WheelEvent;
+
+typedef struct {
+    WheelEvent *events; // pending events are events[first..count)
+    int first;
+    int count;
+    int capacity;
+} WheelSlot;
+
+typedef struct {
+    WheelSlot slots[WHEEL_LEVELS][WHEEL_SLOTS];
+    uint64_t occupied[WHEEL_LEVELS][WHEEL_SLOTS / 64];
+    int size;   // pending events
+    int now;
+} TimingWheel;
+
+void timing_wheel_init(TimingWheel *w);
+void timing_wheel_free(TimingWheel *w);
+bool timing_wheel_push(TimingWheel *w, int time, int value);
+
+// Remove the earliest event if it is due by `limit`, and move the clock to
+// it. Returns false, with the clock at or before `limit`, if none is, or
+// with errno set to ENOMEM and the events untouched if a cascade could not
+// allocate.
+bool timing_wheel_pop_until(TimingWheel *w, int limit, int *time, int *value);
+
+static inline bool timing_wheel_pop(TimingWheel *w, int *time, int *value) {
+    return timing_wheel_pop_until(w, INT_MAX, time, value);
+}
+
+static inline bool timing_wheel_empty(const TimingWheel *w) {
+    return w->size == 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TIMING_WHEEL_H
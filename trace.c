@@ -0,0 +1,295 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "trace.h"
+
+#define TRACE_WRITE_BUFFER (1 << 20)
+
+static const char file_magic[8] = "QTRACE";
+static const char index_magic[8] = "QTRIDX";
+
+_Static_assert(sizeof(TraceFileHeader) % 8 == 0, "file header keeps frames aligned");
+_Static_assert(sizeof(TraceFrameHeader) % 4 == 0, "frame header keeps rows aligned");
+_Static_assert(sizeof(TraceRow) % 4 == 0, "rows are fixed-width and aligned");
+
+/* ---------------------------------------------------------------------- */
+/* Writer                                                                  */
+/* ---------------------------------------------------------------------- */
+
+static bool write_bytes(TraceWriter *w, const void *data, size_t size) {
+    if (size > 0 && fwrite(data, size, 1, w->file) != 1) return false;
+    w->offset += size;
+    return true;
+}
+
+bool trace_open(TraceWriter *w, const char *path, int keyframe_interval) {
+    memset(w, 0, sizeof(*w));
+    w->keyframe_interval = keyframe_interval > 0 ? (uint32_t)keyframe_interval : 1;
+
+    w->file = fopen(path, "wb");
+    if (w->file == NULL) return false;
+    setvbuf(w->file, NULL, _IOFBF, TRACE_WRITE_BUFFER);
+
+    TraceFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, file_magic, sizeof(header.magic));
+    header.version = TRACE_VERSION;
+    header.states = MAX_STATES;
+    header.keyframe_interval = w->keyframe_interval;
+    header.row_size = sizeof(TraceRow);
+    return write_bytes(w, &header, sizeof(header));
+}
+
+static bool grow_rows(TraceWriter *w, int count) {
+    if (count <= w->row_capacity) return true;
+
+    int capacity = w->row_capacity > 0 ? w->row_capacity : 16;
+    while (capacity < count) capacity *= 2;
+
+    TraceRow *previous = realloc(w->previous, (size_t)capacity * sizeof(TraceRow));
+    if (previous == NULL) return false;
+    w->previous = previous;
+
+    TraceRow *changed = realloc(w->changed, (size_t)capacity * sizeof(TraceRow));
+    if (changed == NULL) return false;
+    w->changed = changed;
+
+    w->row_capacity = capacity;
+    return true;
+}
+
+void trace_fill_row(TraceRow *row, const ProcessStore *store, int slot) {
+    memset(row, 0, sizeof(*row));
+    row->slot = slot;
+    row->id = store->id[slot];
+    row->burst_time = store->burst_time[slot];
+    row->waiting_time = store_waiting_time(store, slot);
+    row->system_priority = store->system_priority[slot];
+    row->cpu_utilization = store->cpu_utilization[slot];
+    row->memory_usage = store->memory_usage[slot];
+    row->completed = store->completed[slot];
+    memcpy(row->q, store->q_table[slot], sizeof(row->q));
+}
+
+static bool begin_frame(TraceWriter *w, int count) {
+    if (!grow_rows(w, count)) return false;
+
+    if (w->frame_count == w->frame_capacity) {
+        uint32_t capacity = w->frame_capacity > 0 ? w->frame_capacity * 2 : 64;
+        uint64_t *offsets = realloc(w->frame_offsets, (size_t)capacity * sizeof(uint64_t));
+        if (offsets == NULL) return false;
+        w->frame_offsets = offsets;
+        w->frame_capacity = capacity;
+    }
+    return true;
+}
+
+// Queue the row for the current frame if it differs from the last frame.
+static void add_row(TraceWriter *w, const TraceRow *row, bool keyframe, int *changed) {
+    int slot = row->slot;
+    if (keyframe || slot >= w->previous_count || memcmp(row, &w->previous[slot], sizeof(*row)) != 0) {
+        w->changed[(*changed)++] = *row;
+        w->previous[slot] = *row;
+    }
+}
+
+static bool end_frame(TraceWriter *w, int count, int changed, int selected_process, bool keyframe, bool last) {
+    w->previous_count = count;
+
+    TraceFrameHeader header;
+    header.magic = TRACE_FRAME_MAGIC;
+    header.iteration = w->frame_count;
+    header.selected_process = selected_process;
+    header.flags = (last ? TRACE_FRAME_LAST : 0) | (keyframe ? TRACE_FRAME_KEYFRAME : 0);
+    header.process_count = (uint32_t)count;
+    header.row_count = (uint32_t)changed;
+
+    w->frame_offsets[w->frame_count++] = w->offset;
+    return write_bytes(w, &header, sizeof(header)) &&
+           write_bytes(w, w->changed, (size_t)changed * sizeof(TraceRow));
+}
+
+// Append the process table and Q-table as they are now.
+// selected_process is the process about to run; last marks the final frame.
+bool trace_write_frame(TraceWriter *w, const ProcessStore *store, int selected_process, bool last) {
+    if (!begin_frame(w, store->count)) return false;
+
+    bool keyframe = w->frame_count % w->keyframe_interval == 0;
+    int changed = 0;
+    for (int i = 0; i < store->count; i++) {
+        TraceRow row;
+        trace_fill_row(&row, store, i);
+        add_row(w, &row, keyframe, &changed);
+    }
+    return end_frame(w, store->count, changed, selected_process, keyframe, last);
+}
+
+// Same as trace_write_frame() for rows already copied out of the store,
+// rows[i] being slot i.
+bool trace_write_rows(TraceWriter *w, const TraceRow *rows, int count, int selected_process, bool last) {
+    if (!begin_frame(w, count)) return false;
+
+    bool keyframe = w->frame_count % w->keyframe_interval == 0;
+    int changed = 0;
+    for (int i = 0; i < count; i++) {
+        add_row(w, &rows[i], keyframe, &changed);
+    }
+    return end_frame(w, count, changed, selected_process, keyframe, last);
+}
+
+// Write the frame index and trailer, then close the file.
+bool trace_close(TraceWriter *w) {
+    bool ok = w->file != NULL;
+
+    if (ok) {
+        static const char padding[8];
+        TraceTrailer trailer;
+        memset(&trailer, 0, sizeof(trailer));
+
+        ok = write_bytes(w, padding, (8 - w->offset % 8) % 8);
+        trailer.index_offset = w->offset;
+        trailer.frame_count = w->frame_count;
+        memcpy(trailer.magic, index_magic, sizeof(trailer.magic));
+
+        ok = ok &&
+             write_bytes(w, w->frame_offsets, (size_t)w->frame_count * sizeof(uint64_t)) &&
+             write_bytes(w, &trailer, sizeof(trailer));
+        ok = fclose(w->file) == 0 && ok;
+    }
+
+    free(w->frame_offsets);
+    free(w->previous);
+    free(w->changed);
+    memset(w, 0, sizeof(*w));
+    return ok;
+}
+
+/* ---------------------------------------------------------------------- */
+/* Reader                                                                  */
+/* ---------------------------------------------------------------------- */
+
+static bool read_frame_header(const TraceReader *r, uint64_t offset, TraceFrameHeader *header) {
+    if (offset + sizeof(*header) > r->size) return false;
+    memcpy(header, r->data + offset, sizeof(*header));
+    if (header->magic != TRACE_FRAME_MAGIC) return false;
+    return offset + sizeof(*header) + (uint64_t)header->row_count * sizeof(TraceRow) <= r->size;
+}
+
+// Use the index footer if the trace was closed, otherwise walk the frames.
+static bool load_index(TraceReader *r) {
+    if (r->size >= sizeof(TraceFileHeader) + sizeof(TraceTrailer)) {
+        TraceTrailer trailer;
+        memcpy(&trailer, r->data + r->size - sizeof(trailer), sizeof(trailer));
+        if (memcmp(trailer.magic, index_magic, sizeof(trailer.magic)) == 0 &&
+            trailer.index_offset % 8 == 0 &&
+            trailer.index_offset + trailer.frame_count * sizeof(uint64_t) + sizeof(trailer) == r->size) {
+            r->offsets = (const uint64_t *)(r->data + trailer.index_offset);
+            r->frame_count = (uint32_t)trailer.frame_count;
+            return true;
+        }
+    }
+
+    uint32_t capacity = 64;
+    r->recovered_offsets = malloc(capacity * sizeof(uint64_t));
+    if (r->recovered_offsets == NULL) return false;
+
+    uint64_t offset = sizeof(TraceFileHeader);
+    TraceFrameHeader header;
+    while (read_frame_header(r, offset, &header)) {
+        if (r->frame_count == capacity) {
+            capacity *= 2;
+            uint64_t *offsets = realloc(r->recovered_offsets, capacity * sizeof(uint64_t));
+            if (offsets == NULL) return false;
+            r->recovered_offsets = offsets;
+        }
+        r->recovered_offsets[r->frame_count++] = offset;
+        offset += sizeof(header) + (uint64_t)header.row_count * sizeof(TraceRow);
+    }
+    r->offsets = r->recovered_offsets;
+    return true;
+}
+
+bool trace_reader_open(TraceReader *r, const char *path) {
+    memset(r, 0, sizeof(*r));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TraceFileHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+    r->data = data;
+    r->size = (size_t)st.st_size;
+
+    memcpy(&r->header, r->data, sizeof(r->header));
+    if (memcmp(r->header.magic, file_magic, sizeof(r->header.magic)) != 0 ||
+        r->header.version != TRACE_VERSION ||
+        r->header.states != MAX_STATES ||
+        r->header.row_size != sizeof(TraceRow) ||
+        r->header.keyframe_interval == 0 ||
+        !load_index(r)) {
+        trace_reader_close(r);
+        return false;
+    }
+    return true;
+}
+
+void trace_reader_close(TraceReader *r) {
+    if (r->data != NULL) {
+        munmap((void *)r->data, r->size);
+    }
+    free(r->recovered_offsets);
+    memset(r, 0, sizeof(*r));
+}
+
+// Rebuild the full tables of one frame from the keyframe at or before it.
+bool trace_read_frame(const TraceReader *r, uint32_t frame, TraceFrame *out) {
+    if (frame >= r->frame_count) return false;
+
+    TraceFrameHeader target;
+    if (!read_frame_header(r, r->offsets[frame], &target)) return false;
+
+    if (target.process_count > out->row_capacity) {
+        TraceRow *rows = realloc(out->rows, (size_t)target.process_count * sizeof(TraceRow));
+        if (rows == NULL) return false;
+        out->rows = rows;
+        out->row_capacity = target.process_count;
+    }
+
+    uint32_t keyframe = frame - frame % r->header.keyframe_interval;
+    for (uint32_t f = keyframe; f <= frame; f++) {
+        TraceFrameHeader header;
+        if (!read_frame_header(r, r->offsets[f], &header)) return false;
+        if (f == keyframe && !(header.flags & TRACE_FRAME_KEYFRAME)) return false;
+
+        const unsigned char *rows = r->data + r->offsets[f] + sizeof(header);
+        for (uint32_t k = 0; k < header.row_count; k++) {
+            TraceRow row;
+            memcpy(&row, rows + (size_t)k * sizeof(TraceRow), sizeof(row));
+            if (row.slot < 0 || (uint32_t)row.slot >= target.process_count) return false;
+            out->rows[row.slot] = row;
+        }
+    }
+
+    out->iteration = target.iteration;
+    out->selected_process = target.selected_process;
+    out->flags = target.flags;
+    out->process_count = target.process_count;
+    return true;
+}
+
+void trace_frame_free(TraceFrame *frame) {
+    free(frame->rows);
+    memset(frame, 0, sizeof(*frame));
+}
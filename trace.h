@@ -0,0 +1,119 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "process_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Binary simulation trace, replacing one output_iteration_N.txt per step.
+//
+// Layout (host byte order, every record 4-byte aligned):
+//   TraceFileHeader
+//   frame 0, frame 1, ...   each a TraceFrameHeader followed by row_count TraceRows
+//   uint64_t offsets[frame_count]   file offset of every frame (8-byte aligned)
+//   TraceTrailer
+//
+// A frame only stores the rows that changed since the previous frame.
+// Every keyframe_interval-th frame is a keyframe holding all rows, so any
+// iteration is rebuilt from the nearest keyframe without replaying the run.
+// A trace whose writer never reached trace_close() has no index; the reader
+// then recovers the frame offsets by scanning the frames.
+
+#define TRACE_VERSION 1
+#define TRACE_FRAME_MAGIC 0x4d415246u // "FRAM"
+#define TRACE_DEFAULT_KEYFRAME_INTERVAL 64
+#define TRACE_DEFAULT_FILE "simulation_trace.qtr"
+
+#define TRACE_FRAME_LAST 0x1     // all processes completed after this frame
+#define TRACE_FRAME_KEYFRAME 0x2 // frame holds every row
+
+typedef struct {
+    char magic[8];  // "QTRACE\0\0"
+    uint32_t version;
+    uint32_t states;
+    uint32_t keyframe_interval;
+    uint32_t row_size;
+} TraceFileHeader;
+
+typedef struct {
+    uint32_t magic;  // TRACE_FRAME_MAGIC
+    uint32_t iteration;
+    int32_t selected_process;
+    uint32_t flags;
+    uint32_t process_count;
+    uint32_t row_count;
+} TraceFrameHeader;
+
+typedef struct {
+    int32_t slot;
+    int32_t id;
+    int32_t burst_time;
+    int32_t waiting_time;
+    int32_t system_priority;
+    float cpu_utilization;
+    float memory_usage;
+    uint8_t completed;
+    uint8_t reserved[3];
+    float q[MAX_STATES];
+} TraceRow;
+
+typedef struct {
+    uint64_t index_offset;
+    uint64_t frame_count;
+    char magic[8];  // "QTRIDX\0\0"
+} TraceTrailer;
+
+typedef struct {
+    FILE *file;
+    uint32_t keyframe_interval;
+    uint64_t offset;        // bytes written so far
+    uint64_t *frame_offsets;
+    uint32_t frame_count;
+    uint32_t frame_capacity;
+    TraceRow *previous;     // rows as of the last frame, for delta encoding
+    TraceRow *changed;      // rows of the frame being written
+    int row_capacity;
+    int previous_count;
+} TraceWriter;
+
+bool trace_open(TraceWriter *w, const char *path, int keyframe_interval);
+bool trace_write_frame(TraceWriter *w, const ProcessStore *store, int selected_process, bool last);
+bool trace_write_rows(TraceWriter *w, const TraceRow *rows, int count, int selected_process, bool last);
+void trace_fill_row(TraceRow *row, const ProcessStore *store, int slot);
+bool trace_close(TraceWriter *w);
+
+// Full process table and Q-table of one iteration
+typedef struct {
+    uint32_t iteration;
+    int32_t selected_process;
+    uint32_t flags;
+    uint32_t process_count;
+    TraceRow *rows;  // process_count rows, indexed by slot
+    uint32_t row_capacity;
+} TraceFrame;
+
+typedef struct {
+    const unsigned char *data;  // whole file, memory-mapped
+    size_t size;
+    TraceFileHeader header;
+    const uint64_t *offsets;    // points into data, or owned when recovered by a scan
+    uint64_t *recovered_offsets;
+    uint32_t frame_count;
+} TraceReader;
+
+bool trace_reader_open(TraceReader *r, const char *path);
+void trace_reader_close(TraceReader *r);
+bool trace_read_frame(const TraceReader *r, uint32_t frame, TraceFrame *out);
+void trace_frame_free(TraceFrame *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TRACE_H
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+// Converts a simulation trace back into the output_iteration_N.txt files
+// the simulators used to write, one per frame.
+//   gui        - layout read by the Qt front end (default)
+//   integrable - layout of Simulation_Integrable_code_Q_Table.c
+
+static void write_iteration(FILE *file, const TraceFrame *frame, bool gui) {
+    fprintf(file, "Current Process States:\n");
+    fprintf(file, "ID\tBurst\tWait\tPriority\tCPU%%\tMemory%%\tCompleted\n");
+    for (uint32_t i = 0; i < frame->process_count; i++) {
+        const TraceRow *p = &frame->rows[i];
+        fprintf(file, gui ? "%d\t%d\t%d\t%d\t%.2f\t%.2f\t%s\n"
+                          : "%d\t%d\t\t%d\t\t%d\t\t\t%.2f\t%.2f\t%s\n",
+                p->id, p->burst_time, p->waiting_time,
+                p->system_priority, p->cpu_utilization,
+                p->memory_usage, p->completed ? "Yes" : "No");
+    }
+
+    // Q-table headers
+    fprintf(file, "\nQ-Table:\n");
+    fprintf(file, "Process ID\tPriority\tCPU Utilization\tMemory Usage\tWaiting Time\tBurst Time\n");
+
+    for (uint32_t i = 0; i < frame->process_count; i++) {
+        const float *q = frame->rows[i].q;
+        fprintf(file, gui ? "Process %u " : "Process %u: ", i);
+        fprintf(file, gui ? "\t%.2f\t%.2f\t%.2f\t%.2f\t%.2f\t\n"
+                          : " %.2f\t\t%.2f\t\t\t%.2f\t\t\t%.2f\t\t\t%.2f\t\n",
+                q[0], q[1], q[2], q[3], q[4]);
+    }
+    if (!(frame->flags & TRACE_FRAME_LAST)) {
+        // Slots follow arrival order, so name the process by its ID
+        int selected = frame->selected_process;
+        fprintf(file, "\nWill now execute Process ID: %d\n",
+                selected >= 0 && (uint32_t)selected < frame->process_count ? frame->rows[selected].id : selected);
+    }
+    else {
+        fprintf(file, "\nAll processes completed!\n");
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || (argc > 2 && strcmp(argv[2], "gui") != 0 && strcmp(argv[2], "integrable") != 0)) {
+        fprintf(stderr, "Usage: %s <trace_file> [gui|integrable]\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    bool gui = argc < 3 || strcmp(argv[2], "gui") == 0;
+
+    TraceReader reader;
+    if (!trace_reader_open(&reader, argv[1])) {
+        fprintf(stderr, "Error opening trace file %s\n", argv[1]);
+        return EXIT_FAILURE;
+    }
+
+    TraceFrame frame = {0};
+    for (uint32_t i = 0; i < reader.frame_count; i++) {
+        if (!trace_read_frame(&reader, i, &frame)) {
+            fprintf(stderr, "Corrupt frame %u in %s\n", i, argv[1]);
+            return EXIT_FAILURE;
+        }
+
+        char filename[50];
+        sprintf(filename, "output_iteration_%u.txt", frame.iteration);
+        FILE *file = fopen(filename, "w");
+        if (file == NULL) {
+            perror("Error opening file");
+            exit(EXIT_FAILURE);
+        }
+        write_iteration(file, &frame, gui);
+        fclose(file);
+    }
+
+    printf("Wrote %u iterations from %s\n", reader.frame_count, argv[1]);
+    trace_frame_free(&frame);
+    trace_reader_close(&reader);
+    return 0;
+}
@@ -0,0 +1,98 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "dqn_train.h"
+
+// train_scheduler() of Deep_Q_RL_based_Simulator.py in C++: the same
+// environment, network and hyperparameters, one optimization step per
+// environment step and a target sync per episode. Prints the episodes as
+// the Python script does, then environment steps per second, which the
+// Python script prints too, and writes the policy network in the format
+// of export_weights() for build/dqn_bench --model.
+
+struct TrainConfig {
+    DqnTrainConfig dqn;
+    int episodes = 50;
+    int processes = 5; // NUM_PROCESSES
+    const char* outPath = "dqn_weights.bin";
+    bool quiet = false;
+};
+
+static double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void usage(const char* program) {
+    std::fprintf(stderr,
+                 "Usage: %s [--episodes N] [--processes N] [--threads N] [--batch N] [--memory N]\n"
+                 "          [--seed N] [--out FILE] [--quiet 1]\n",
+                 program);
+    std::exit(EXIT_FAILURE);
+}
+
+int main(int argc, char* argv[]) {
+    TrainConfig config;
+    for (int i = 1; i < argc; i++) {
+        if (i + 1 >= argc) usage(argv[0]);
+        char* value = argv[++i];
+        if (std::strcmp(argv[i - 1], "--episodes") == 0) config.episodes = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--processes") == 0) config.processes = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--threads") == 0) config.dqn.threads = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--batch") == 0) config.dqn.batchSize = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--memory") == 0) config.dqn.memorySize = std::atoi(value);
+        else if (std::strcmp(argv[i - 1], "--seed") == 0) config.dqn.seed = std::strtoull(value, nullptr, 0);
+        else if (std::strcmp(argv[i - 1], "--out") == 0) config.outPath = value;
+        else if (std::strcmp(argv[i - 1], "--quiet") == 0) config.quiet = std::atoi(value) != 0;
+        else usage(argv[0]);
+    }
+    if (config.episodes < 1 || config.processes < 1 || config.dqn.threads < 1 || config.dqn.batchSize < 1 ||
+        config.dqn.memorySize < config.dqn.batchSize) {
+        usage(argv[0]);
+    }
+
+    DqnEnv env(config.processes, config.dqn.seed);
+    DqnTrainer trainer(config.dqn, {DqnEnv::Features, 64, 64, config.processes});
+
+    float state[DqnEnv::Features], next[DqnEnv::Features];
+    long steps = 0, updates = 0;
+    double waiting = 0.0;
+    double start = nowSeconds();
+    for (int episode = 0; episode < config.episodes; episode++) {
+        env.reset();
+        env.state(state);
+        double total = 0.0;
+        bool done = false;
+        while (!done) {
+            int action = trainer.act(state);
+            float reward;
+            done = env.step(action, &reward);
+            env.state(next);
+
+            trainer.remember(state, action, reward, next, done);
+            if (trainer.optimize()) updates++;
+
+            std::memcpy(state, next, sizeof(state));
+            total += reward;
+            steps++;
+        }
+        trainer.syncTarget();
+        waiting += env.meanWaiting();
+        if (!config.quiet) {
+            std::printf("Episode %d, Total Reward: %.2f, Epsilon: %.2f\n", episode, total, trainer.epsilon());
+        }
+    }
+    double seconds = nowSeconds() - start;
+
+    std::printf("Trained %ld steps in %.2f s (%.0f steps/s), %ld updates, %d threads, mean waiting %.2f\n", steps,
+                seconds, seconds > 0.0 ? steps / seconds : 0.0, updates, trainer.threads(),
+                waiting / config.episodes);
+
+    if (!trainer.model().save(config.outPath)) {
+        std::perror("Error writing model");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,566 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <float.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "checksum.h"
+#include "workload.h"
+
+#define WORKLOAD_FIELDS 8 // the last, arrival_time, may be left out
+#define WORKLOAD_MIN_CHUNK (1 << 20) // bytes per thread; smaller files use fewer threads
+#define FLOAT_TEXT_MAX 64
+
+typedef struct {
+    const char *begin;
+    const char *end;     // just past the chunk's last newline
+    ProcessStore *store;
+
+    // Counting pass
+    long records;
+    long lines;
+
+    // Parsing pass
+    int first_slot;
+    long first_line;
+    long bad_lines;
+    int reported;
+    long error_line[WORKLOAD_MAX_REPORTED_ERRORS];
+    const char *error_reason[WORKLOAD_MAX_REPORTED_ERRORS];
+} Chunk;
+
+static const char *field_errors[WORKLOAD_FIELDS] = {
+    "invalid id",
+    "invalid burst_time (expected a non-negative integer)",
+    "invalid waiting_time (expected a non-negative integer)",
+    "invalid system_priority",
+    "invalid cpu_utilization",
+    "invalid memory_usage",
+    "invalid completed (expected true or false)",
+    "invalid arrival_time (expected a non-negative integer)",
+};
+
+static const char *field_count_error = "expected 7 or 8 comma-separated fields";
+
+static inline bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static const char *line_end(const char *p, const char *end) {
+    const char *newline = memchr(p, '\n', (size_t)(end - p));
+    return newline != NULL ? newline : end;
+}
+
+static bool is_blank(const char *p, const char *end) {
+    while (p < end && is_space(*p)) p++;
+    return p == end;
+}
+
+/* ---------------------------------------------------------------------- */
+/* Field parsers                                                           */
+/* ---------------------------------------------------------------------- */
+
+// Like std::from_chars: parse a value at p, without locale or leading
+// whitespace, and return the first character not consumed, or NULL if
+// there is no valid value at p.
+
+static const char *parse_int(const char *p, const char *end, int *out) {
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) negative = *p++ == '-';
+
+    const char *digits = p;
+    int64_t value = 0;
+    for (; p < end && (unsigned)(*p - '0') <= 9; p++) {
+        value = value * 10 + (*p - '0');
+        if (value > (int64_t)INT_MAX + 1) return NULL;
+    }
+    if (p == digits) return NULL;
+    if (negative) value = -value;
+    if (value > INT_MAX) return NULL;
+    *out = (int)value;
+    return p;
+}
+
+static const char *parse_float(const char *p, const char *end, float *out) {
+    static const float powers[] = {1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f,
+                                   1e6f, 1e7f, 1e8f, 1e9f, 1e10f};
+    const char *start = p;
+    bool negative = false;
+    if (p < end && (*p == '+' || *p == '-')) negative = *p++ == '-';
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    bool digits = false;
+    for (; p < end && (unsigned)(*p - '0') <= 9; p++, digits = true) {
+        if (mantissa < UINT64_MAX / 10 - 9) mantissa = mantissa * 10 + (unsigned)(*p - '0');
+        else exponent++;
+    }
+    if (p < end && *p == '.') {
+        for (p++; p < end && (unsigned)(*p - '0') <= 9; p++, digits = true) {
+            if (mantissa < UINT64_MAX / 10 - 9) {
+                mantissa = mantissa * 10 + (unsigned)(*p - '0');
+                exponent--;
+            }
+        }
+    }
+    if (!digits) return NULL;
+    if (p < end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool negative_exponent = false;
+        if (p < end && (*p == '+' || *p == '-')) negative_exponent = *p++ == '-';
+        if (p == end || (unsigned)(*p - '0') > 9) return NULL;
+        int e = 0;
+        for (; p < end && (unsigned)(*p - '0') <= 9; p++) {
+            if (e < 100000) e = e * 10 + (*p - '0');
+        }
+        exponent += negative_exponent ? -e : e;
+    }
+
+#if FLT_EVAL_METHOD == 0
+    // Both operands are exact floats, so one correctly rounded multiply or
+    // divide gives the same float as strtof()
+    if (mantissa <= (1u << 24) && exponent >= -10 && exponent <= 10) {
+        float value = (float)mantissa;
+        value = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+        *out = negative ? -value : value;
+        return p;
+    }
+#else
+    (void)powers;
+#endif
+
+    size_t length = (size_t)(p - start);
+    if (length >= FLOAT_TEXT_MAX) return NULL;
+    char text[FLOAT_TEXT_MAX];
+    memcpy(text, start, length);
+    text[length] = '\0';
+    char *stop;
+    *out = strtof(text, &stop);
+    return stop == text + length ? p : NULL;
+}
+
+static const char *parse_completed(const char *p, const char *end, bool *out) {
+    size_t length = (size_t)(end - p);
+    if (length >= 4 && memcmp(p, "true", 4) == 0) {
+        *out = true;
+        return p + 4;
+    }
+    if (length >= 5 && memcmp(p, "false", 5) == 0) {
+        *out = false;
+        return p + 5;
+    }
+    return NULL;
+}
+
+static inline const char *skip_spaces(const char *p, const char *end) {
+    while (p < end && is_space(*p)) p++;
+    return p;
+}
+
+// After a field's value: step over trailing spaces and the comma (or, for
+// the last field, require the end of the line). Returns the next field, or
+// NULL with *reason set.
+static const char *end_field(const char *p, const char *end, int field, const char **reason) {
+    if (p == NULL) {
+        *reason = field_errors[field];
+        return NULL;
+    }
+    p = skip_spaces(p, end);
+    if (field + 1 == WORKLOAD_FIELDS) {
+        if (p == end) return p;
+        *reason = *p == ',' ? field_count_error : field_errors[field];
+        return NULL;
+    }
+    if (p < end && *p == ',') return skip_spaces(p + 1, end);
+    *reason = p == end ? field_count_error : field_errors[field];
+    return NULL;
+}
+
+// Parse one line into the store at `slot`. Returns NULL, or why the line
+// is invalid.
+static const char *parse_line(const char *p, const char *end, ProcessStore *store, int slot) {
+    int id, burst, waiting, priority, arrival = 0;
+    float cpu, memory;
+    bool completed = false;
+    const char *reason = NULL;
+
+    p = skip_spaces(p, end);
+    if ((p = end_field(parse_int(p, end, &id), end, 0, &reason)) == NULL) return reason;
+    if ((p = end_field(parse_int(p, end, &burst), end, 1, &reason)) == NULL) return reason;
+    if ((p = end_field(parse_int(p, end, &waiting), end, 2, &reason)) == NULL) return reason;
+    if ((p = end_field(parse_int(p, end, &priority), end, 3, &reason)) == NULL) return reason;
+    if ((p = end_field(parse_float(p, end, &cpu), end, 4, &reason)) == NULL) return reason;
+    if ((p = end_field(parse_float(p, end, &memory), end, 5, &reason)) == NULL) return reason;
+    if ((p = parse_completed(p, end, &completed)) == NULL) return field_errors[6];
+    p = skip_spaces(p, end);
+    if (p < end) {
+        if (*p != ',') return field_errors[6];
+        p = skip_spaces(p + 1, end);
+        if ((p = end_field(parse_int(p, end, &arrival), end, 7, &reason)) == NULL) return reason;
+    }
+    if (burst < 0) return field_errors[1];
+    if (waiting < 0) return field_errors[2];
+    if (arrival < 0) return field_errors[7];
+
+    store->id[slot] = id;
+    store->burst_time[slot] = burst;
+    store->waiting_time[slot] = waiting;
+    store->system_priority[slot] = priority;
+    store->cpu_utilization[slot] = cpu;
+    store->memory_usage[slot] = memory;
+    store->completed[slot] = completed;
+    store->arrival_time[slot] = arrival;
+    return NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+/* Chunk passes                                                            */
+/* ---------------------------------------------------------------------- */
+
+static void *count_chunk(void *arg) {
+    Chunk *chunk = arg;
+    for (const char *p = chunk->begin; p < chunk->end;) {
+        const char *eol = line_end(p, chunk->end);
+        chunk->lines++;
+        if (!is_blank(p, eol)) chunk->records++;
+        p = eol + 1;
+    }
+    return NULL;
+}
+
+static void *parse_chunk(void *arg) {
+    Chunk *chunk = arg;
+    int slot = chunk->first_slot;
+    long line = chunk->first_line;
+
+    for (const char *p = chunk->begin; p < chunk->end; line++) {
+        const char *eol = line_end(p, chunk->end);
+        if (!is_blank(p, eol)) {
+            const char *reason = parse_line(p, eol, chunk->store, slot++);
+            if (reason != NULL) {
+                if (chunk->reported < WORKLOAD_MAX_REPORTED_ERRORS) {
+                    chunk->error_line[chunk->reported] = line;
+                    chunk->error_reason[chunk->reported] = reason;
+                    chunk->reported++;
+                }
+                chunk->bad_lines++;
+            }
+        }
+        p = eol + 1;
+    }
+    return NULL;
+}
+
+// Run `pass` on every chunk, the first on the calling thread
+static void run_chunks(Chunk *chunks, int count, void *(*pass)(void *)) {
+    pthread_t threads[count];
+    bool started[count];
+
+    for (int i = 1; i < count; i++) {
+        started[i] = pthread_create(&threads[i], NULL, pass, &chunks[i]) == 0;
+        if (!started[i]) pass(&chunks[i]);
+    }
+    pass(&chunks[0]);
+    for (int i = 1; i < count; i++) {
+        if (started[i]) pthread_join(threads[i], NULL);
+    }
+}
+
+bool workload_load_csv(ProcessStore *store, const char *path, int threads, WorkloadStats *stats) {
+    memset(stats, 0, sizeof(*stats));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    size_t size = (size_t)st.st_size;
+    if (size == 0) {
+        close(fd);
+        return true;
+    }
+    const char *data = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+    posix_madvise((void *)data, size, POSIX_MADV_SEQUENTIAL);
+
+    if (threads <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = cores > 0 ? (int)cores : 1;
+    }
+    if ((size_t)threads > size / WORKLOAD_MIN_CHUNK + 1) {
+        threads = (int)(size / WORKLOAD_MIN_CHUNK + 1);
+    }
+
+    Chunk *chunks = calloc((size_t)threads, sizeof(Chunk));
+    if (chunks == NULL) {
+        munmap((void *)data, size);
+        return false;
+    }
+
+    // Cut at the first newline after each even split
+    const char *file_end = data + size;
+    const char *p = data;
+    int count = 0;
+    for (int i = 0; i < threads && p < file_end; i++) {
+        const char *cut = i + 1 < threads ? data + size / (size_t)threads * (size_t)(i + 1) : file_end;
+        if (cut < p) cut = p;
+        cut = cut < file_end ? line_end(cut, file_end) : file_end;
+        if (cut < file_end) cut++;
+
+        chunks[count].begin = p;
+        chunks[count].end = cut;
+        chunks[count].store = store;
+        count++;
+        p = cut;
+    }
+
+    run_chunks(chunks, count, count_chunk);
+
+    long total = 0, lines = 0;
+    for (int i = 0; i < count; i++) {
+        chunks[i].first_slot = store->count + (int)total;
+        chunks[i].first_line = lines + 1;
+        total += chunks[i].records;
+        lines += chunks[i].lines;
+        if (total > INT_MAX - store->count) {
+            free(chunks);
+            munmap((void *)data, size);
+            errno = EOVERFLOW;
+            return false;
+        }
+    }
+    if (!store_reserve(store, store->count + (int)total)) {
+        free(chunks);
+        munmap((void *)data, size);
+        errno = ENOMEM;
+        return false;
+    }
+
+    run_chunks(chunks, count, parse_chunk);
+
+    int reported = 0;
+    for (int i = 0; i < count; i++) {
+        stats->bad_lines += chunks[i].bad_lines;
+        for (int e = 0; e < chunks[i].reported && reported < WORKLOAD_MAX_REPORTED_ERRORS; e++, reported++) {
+            fprintf(stderr, "%s:%ld: %s\n", path, chunks[i].error_line[e], chunks[i].error_reason[e]);
+        }
+    }
+    if (stats->bad_lines > reported) {
+        fprintf(stderr, "%s: %ld more invalid lines\n", path, stats->bad_lines - reported);
+    }
+    stats->lines = lines;
+
+    free(chunks);
+    munmap((void *)data, size);
+    if (stats->bad_lines > 0) return false;
+
+    int first = store->count;
+    store->count += (int)total;
+    store_adopt_rows(store, first);
+    stats->records = total;
+    return true;
+}
+
+/* ---------------------------------------------------------------------- */
+/* Compiled workloads                                                      */
+/* ---------------------------------------------------------------------- */
+
+static const char workload_magic[8] = "QWLOAD";
+
+static const size_t column_element_size[WORKLOAD_COLUMNS] = {
+    sizeof(int32_t), sizeof(int32_t), sizeof(int32_t), sizeof(int32_t),
+    sizeof(float), sizeof(float), sizeof(uint8_t), sizeof(int32_t),
+};
+
+// Version 1 files end before the arrival_time column; their processes
+// all arrive at 0
+static uint32_t version_columns(uint32_t version) {
+    if (version == 1) return WORKLOAD_ARRIVAL_TIME;
+    if (version == WORKLOAD_VERSION) return WORKLOAD_COLUMNS;
+    return 0;
+}
+
+_Static_assert(sizeof(WorkloadFileHeader) % 8 == 0, "header has no tail padding");
+_Static_assert(sizeof(int) == sizeof(int32_t) && sizeof(bool) == sizeof(uint8_t),
+               "store columns are written as they are");
+
+static inline uint64_t align_column(uint64_t offset) {
+    return (offset + WORKLOAD_COLUMN_ALIGNMENT - 1) & ~(uint64_t)(WORKLOAD_COLUMN_ALIGNMENT - 1);
+}
+
+bool workload_write_compiled(const ProcessStore *store, const char *path) {
+    const void *columns[WORKLOAD_COLUMNS] = {
+        store->id, store->burst_time, store->waiting_time, store->system_priority,
+        store->cpu_utilization, store->memory_usage, store->completed, store->arrival_time,
+    };
+
+    WorkloadFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, workload_magic, sizeof(header.magic));
+    header.version = WORKLOAD_VERSION;
+    header.column_count = WORKLOAD_COLUMNS;
+    header.process_count = (uint64_t)store->count;
+
+    uint64_t offset = sizeof(header);
+    for (int c = 0; c < WORKLOAD_COLUMNS; c++) {
+        offset = align_column(offset);
+        header.columns[c].offset = offset;
+        header.columns[c].size = (uint64_t)store->count * column_element_size[c];
+        header.columns[c].checksum = file_checksum(columns[c], (size_t)header.columns[c].size);
+        offset += header.columns[c].size;
+    }
+    header.header_checksum = file_checksum(&header, offsetof(WorkloadFileHeader, header_checksum));
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) return false;
+
+    static const char padding[WORKLOAD_COLUMN_ALIGNMENT];
+    bool ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    offset = sizeof(header);
+    for (int c = 0; c < WORKLOAD_COLUMNS && ok; c++) {
+        size_t gap = (size_t)(header.columns[c].offset - offset);
+        size_t size = (size_t)header.columns[c].size;
+        ok = (gap == 0 || fwrite(padding, 1, gap, file) == gap) &&
+             (size == 0 || fwrite(columns[c], 1, size, file) == size);
+        offset = header.columns[c].offset + size;
+    }
+    if (fclose(file) != 0) ok = false;
+    return ok;
+}
+
+bool workload_open(WorkloadFile *w, const char *path, bool verify) {
+    memset(w, 0, sizeof(*w));
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    if ((size_t)st.st_size < offsetof(WorkloadFileHeader, columns)) {
+        close(fd);
+        errno = EINVAL;
+        return false;
+    }
+    const char *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return false;
+    w->data = data;
+    w->size = (size_t)st.st_size;
+
+    // The column table, and so the header, is as long as the version's
+    WorkloadFileHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(&header, data, offsetof(WorkloadFileHeader, columns));
+    uint32_t columns = version_columns(header.version);
+    size_t header_size = offsetof(WorkloadFileHeader, columns) + columns * sizeof(WorkloadColumnHeader);
+    int error = 0;
+    if (memcmp(header.magic, workload_magic, sizeof(header.magic)) != 0 ||
+        columns == 0 || header.column_count != columns ||
+        header.process_count > INT_MAX ||
+        w->size < header_size + sizeof(header.header_checksum)) {
+        error = EINVAL;
+    } else {
+        memcpy(header.columns, data + offsetof(WorkloadFileHeader, columns), columns * sizeof(WorkloadColumnHeader));
+        memcpy(&header.header_checksum, data + header_size, sizeof(header.header_checksum));
+        if (header.header_checksum != file_checksum(data, header_size)) {
+            error = EBADMSG;
+        }
+    }
+
+    for (uint32_t c = 0; c < columns && error == 0; c++) {
+        const WorkloadColumnHeader *column = &header.columns[c];
+        if (column->offset % WORKLOAD_COLUMN_ALIGNMENT != 0 ||
+            column->size != header.process_count * column_element_size[c] ||
+            column->offset > w->size || column->size > w->size - column->offset) {
+            error = EINVAL;
+        } else if (verify && column->checksum != file_checksum(data + column->offset, (size_t)column->size)) {
+            error = EBADMSG;
+        }
+    }
+    if (error != 0) {
+        workload_close(w);
+        errno = error;
+        return false;
+    }
+
+    w->count = (int)header.process_count;
+    w->id = (const int32_t *)(data + header.columns[WORKLOAD_ID].offset);
+    w->burst_time = (const int32_t *)(data + header.columns[WORKLOAD_BURST_TIME].offset);
+    w->waiting_time = (const int32_t *)(data + header.columns[WORKLOAD_WAITING_TIME].offset);
+    w->system_priority = (const int32_t *)(data + header.columns[WORKLOAD_SYSTEM_PRIORITY].offset);
+    w->cpu_utilization = (const float *)(data + header.columns[WORKLOAD_CPU_UTILIZATION].offset);
+    w->memory_usage = (const float *)(data + header.columns[WORKLOAD_MEMORY_USAGE].offset);
+    w->completed = (const uint8_t *)(data + header.columns[WORKLOAD_COMPLETED].offset);
+    if (columns > WORKLOAD_ARRIVAL_TIME) {
+        w->arrival_time = (const int32_t *)(data + header.columns[WORKLOAD_ARRIVAL_TIME].offset);
+    }
+    return true;
+}
+
+void workload_close(WorkloadFile *w) {
+    if (w->data != NULL) {
+        munmap((void *)w->data, w->size);
+    }
+    memset(w, 0, sizeof(*w));
+}
+
+static bool is_compiled(const char *path) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    char magic[sizeof(workload_magic)];
+    bool compiled = read(fd, magic, sizeof(magic)) == (ssize_t)sizeof(magic) &&
+                    memcmp(magic, workload_magic, sizeof(magic)) == 0;
+    close(fd);
+    return compiled;
+}
+
+bool workload_load(ProcessStore *store, const char *path, int threads, WorkloadStats *stats) {
+    if (!is_compiled(path)) {
+        return workload_load_csv(store, path, threads, stats);
+    }
+
+    memset(stats, 0, sizeof(*stats));
+    WorkloadFile w;
+    if (!workload_open(&w, path, true)) return false;
+    if (w.count > INT_MAX - store->count || !store_reserve(store, store->count + w.count)) {
+        workload_close(&w);
+        errno = ENOMEM;
+        return false;
+    }
+
+    int first = store->count;
+    size_t n = (size_t)w.count;
+    memcpy(store->id + first, w.id, n * sizeof(int));
+    memcpy(store->burst_time + first, w.burst_time, n * sizeof(int));
+    memcpy(store->waiting_time + first, w.waiting_time, n * sizeof(int));
+    memcpy(store->system_priority + first, w.system_priority, n * sizeof(int));
+    memcpy(store->cpu_utilization + first, w.cpu_utilization, n * sizeof(float));
+    memcpy(store->memory_usage + first, w.memory_usage, n * sizeof(float));
+    for (size_t i = 0; i < n; i++) {
+        store->completed[first + i] = w.completed[i] != 0;
+    }
+    if (w.arrival_time != NULL) {
+        memcpy(store->arrival_time + first, w.arrival_time, n * sizeof(int));
+    } else {
+        memset(store->arrival_time + first, 0, n * sizeof(int));
+    }
+
+    store->count += w.count;
+    store_adopt_rows(store, first);
+    stats->records = w.count;
+    workload_close(&w);
+    return true;
+}
@@ -0,0 +1,114 @@
+#ifndef WORKLOAD_H
+#define WORKLOAD_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "process_store.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Workload files.
+//
+// A CSV workload has one process per line:
+//
+//   id,burst_time,waiting_time,system_priority,cpu_utilization,memory_usage,completed[,arrival_time]
+//
+// with integer ids and times, fractional CPU and memory usage, and
+// completed as true or false. Without arrival_time the process arrives
+// at 0. Blank lines are skipped.
+//
+// workload_load_csv() memory-maps the file and splits it into chunks at
+// line boundaries, one per thread. A first pass counts each chunk's records
+// and lines, so every chunk knows its first store slot and line number; a
+// second pass parses each chunk straight into the store columns. Invalid
+// lines are reported on stderr as "file:line: reason" and nothing is added.
+//
+// A compiled workload (build/compile_workload) holds the same data as
+// columns, so it is memory-mapped and used without parsing:
+//   WorkloadFileHeader
+//   one column per process field, each starting on a 64-byte boundary
+// in host byte order. The header records every column's offset, size and
+// checksum, and its own checksum, so a truncated or corrupted file is
+// rejected instead of loaded. Version 1 files, written before arrival
+// times, are still read.
+
+#define WORKLOAD_MAX_REPORTED_ERRORS 10
+#define WORKLOAD_VERSION 2
+#define WORKLOAD_COLUMN_ALIGNMENT 64
+
+enum {
+    WORKLOAD_ID,
+    WORKLOAD_BURST_TIME,
+    WORKLOAD_WAITING_TIME,
+    WORKLOAD_SYSTEM_PRIORITY,
+    WORKLOAD_CPU_UTILIZATION,
+    WORKLOAD_MEMORY_USAGE,
+    WORKLOAD_COMPLETED,
+    WORKLOAD_ARRIVAL_TIME, // since version 2
+    WORKLOAD_COLUMNS
+};
+
+typedef struct {
+    long records;   // processes appended to the store
+    long lines;
+    long bad_lines; // lines that failed validation
+} WorkloadStats;
+
+typedef struct {
+    uint64_t offset;    // from the start of the file
+    uint64_t size;      // bytes
+    uint64_t checksum;
+} WorkloadColumnHeader;
+
+typedef struct {
+    char magic[8];  // "QWLOAD\0\0"
+    uint32_t version;
+    uint32_t column_count;
+    uint64_t process_count;
+    WorkloadColumnHeader columns[WORKLOAD_COLUMNS];
+    uint64_t header_checksum; // of the bytes before it
+} WorkloadFileHeader;
+
+// A compiled workload mapped read-only; the columns point into the file
+typedef struct {
+    const void *data;
+    size_t size;
+    int count;
+    const int32_t *id;
+    const int32_t *burst_time;
+    const int32_t *waiting_time;
+    const int32_t *system_priority;
+    const float *cpu_utilization;
+    const float *memory_usage;
+    const uint8_t *completed;
+    const int32_t *arrival_time; // NULL for version 1 files
+} WorkloadFile;
+
+// Append the processes in `path` to the store; threads <= 0 uses every
+// online CPU. Returns false with errno set if the file cannot be read or
+// the store cannot grow, or false with bad_lines > 0 if a line is invalid.
+bool workload_load_csv(ProcessStore *store, const char *path, int threads, WorkloadStats *stats);
+
+// Write the store's processes as a compiled workload. Waiting times come
+// from the column as it stands, so settle them first if the store has run.
+bool workload_write_compiled(const ProcessStore *store, const char *path);
+
+// Map a compiled workload. With verify, every column's checksum is
+// checked too; the header's always is. Returns false with errno set
+// (EINVAL for a file that is not a compiled workload of a known version,
+// EBADMSG for a checksum mismatch).
+bool workload_open(WorkloadFile *w, const char *path, bool verify);
+void workload_close(WorkloadFile *w);
+
+// Append a compiled workload, or a CSV one, to the store, whichever
+// `path` holds
+bool workload_load(ProcessStore *store, const char *path, int threads, WorkloadStats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // WORKLOAD_H